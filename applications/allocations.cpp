@@ -0,0 +1,24 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// integrate-cli --profile reports the number of allocations made with operator new. The array and
+// nothrow versions of operator new call this one, so replacing it counts all of them.
+//
+// This is a separate file so that the compiler can not see calls to the replaced operator new and
+// operator delete inlined next to each other.
+std::atomic<std::size_t> allocation_count{0};
+std::atomic<std::size_t> allocation_bytes{0};
+
+void *operator new(std::size_t size)
+{
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+  if(void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
@@ -3,10 +3,17 @@ from conan import ConanFile
 class Pkg(ConanFile):
     generators = "CMakeDeps", "CMakeToolchain",
     settings = "os", "arch", "compiler", "build_type"
+    options = {'with_zlib': [True, False], 'with_zstd': [True, False]}
+    default_options = {'with_zlib': True, 'with_zstd': True}
 
     def requirements(self):
         self.requires("boost/1.85.0")
         self.requires("libinterpolate/2.7")
+        # optional, for reading compressed data files
+        if self.options.with_zlib:
+            self.requires("zlib/1.3.1")
+        if self.options.with_zstd:
+            self.requires("zstd/1.5.6")
 
     def build_requirements(self):
         pass
@@ -1,10 +1,25 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
 #include <fstream>
 #include <functional>
+#include <iomanip>
+#include <iterator>
 #include <iostream>
 #include <list>
+#include <mutex>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/lexical_cast.hpp>
@@ -17,9 +32,138 @@
 #include <libIntegrate/version.h>
 #include <libInterpolate/Interpolate.hpp>
 
+#if !defined(_WIN32)
+#include <cerrno>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 namespace po = boost::program_options;
 
+// the number and size of the allocations made with operator new, counted in allocations.cpp.
+extern std::atomic<std::size_t> allocation_count;
+extern std::atomic<std::size_t> allocation_bytes;
+
+// wall time spent in each phase of a run (reading, extracting, integrating, and writing the output),
+// and counters for the amount of work done, reported with --profile. Phases may be timed from several
+// threads (in batch mode), the times are summed.
+class Profile
+{
+ public:
+  // times a phase from construction to destruction.
+  class Timer
+  {
+   public:
+    Timer(Profile &profile, std::string name) : m_profile(profile), m_name(std::move(name)), m_start(std::chrono::steady_clock::now()) {}
+    ~Timer() { m_profile.add(m_name, std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count()); }
+
+   private:
+    Profile                              &m_profile;
+    std::string                           m_name;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  Timer time(std::string name) { return Timer(*this, std::move(name)); }
+
+  void add(const std::string &name, double seconds)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto phase = std::find_if(m_phases.begin(), m_phases.end(), [&name](const Phase &p) { return p.name == name; });
+    if(phase == m_phases.end())
+      phase = m_phases.insert(m_phases.end(), {name, 0, 0});
+    phase->calls++;
+    phase->seconds += seconds;
+  }
+
+  std::atomic<std::size_t> bytes{0};
+  std::atomic<std::size_t> points{0};
+  std::atomic<std::size_t> evaluations{0};
+  // set with --profile. the evaluations are only counted if it is set, and are added once per integral.
+  bool enabled = false;
+
+  void report(std::ostream &out, const std::string &format) const
+  {
+    double      total = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    std::size_t rss   = 0;
+#if !defined(_WIN32)
+    struct rusage usage;
+    if(::getrusage(RUSAGE_SELF, &usage) == 0)
+      rss = static_cast<std::size_t>(usage.ru_maxrss) * 1024;  // ru_maxrss is in kilobytes
+#endif
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(format == "json") {
+      out << "{\"phases\":[";
+      for(std::size_t i = 0; i < m_phases.size(); i++)
+        out << (i ? "," : "") << "{\"name\":\"" << m_phases[i].name << "\",\"calls\":" << m_phases[i].calls << ",\"seconds\":" << m_phases[i].seconds << "}";
+      out << "],\"total_seconds\":" << total << ",\"bytes_read\":" << bytes << ",\"points\":" << points << ",\"evaluations\":" << evaluations
+          << ",\"allocations\":" << allocation_count << ",\"allocated_bytes\":" << allocation_bytes << ",\"peak_rss_bytes\":" << rss << "}\n";
+      return;
+    }
+
+    std::ios_base::fmtflags flags     = out.flags();
+    std::streamsize         precision = out.precision();
+    out << "phase            calls     seconds\n";
+    for(const auto &phase : m_phases)
+      out << std::left << std::setw(14) << phase.name << std::right << std::setw(8) << phase.calls << std::setw(12) << std::fixed << std::setprecision(6) << phase.seconds << "\n";
+    out << std::left << std::setw(22) << "total" << std::right << std::setw(12) << total << "\n";
+    out << "bytes read:      " << bytes << "\n";
+    out << "points:          " << points << "\n";
+    out << "evaluations:     " << evaluations << "\n";
+    out << "allocations:     " << allocation_count << " (" << allocation_bytes << " bytes)\n";
+    out << "peak RSS:        " << rss << " bytes\n";
+    out.flags(flags);
+    out.precision(precision);
+  }
+
+ private:
+  struct Phase {
+    std::string name;
+    std::size_t calls;
+    double      seconds;
+  };
+  std::vector<Phase>                    m_phases;
+  mutable std::mutex                    m_mutex;
+  std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+};
+
+Profile profile;
+
+// adds the size of a file to the bytes read, for --profile.
+void count_file_bytes(const std::string &path)
+{
+  std::error_code error;
+  auto            size = std::filesystem::file_size(path, error);
+  if(!error)
+    profile.bytes += size;
+}
+
+// a stream buffer that reads from another stream buffer, and counts the bytes read for --profile.
+class CountingStreamBuf : public std::streambuf
+{
+ public:
+  explicit CountingStreamBuf(std::streambuf *source) : m_source(source) {}
+
+ protected:
+  int_type underflow() override
+  {
+    auto count = m_source->sgetn(m_buffer, sizeof(m_buffer));
+    if(count <= 0)
+      return traits_type::eof();
+    profile.bytes += count;
+    setg(m_buffer, m_buffer, m_buffer + count);
+    return traits_type::to_int_type(m_buffer[0]);
+  }
+
+ private:
+  std::streambuf *m_source;
+  char            m_buffer[1 << 16];
+};
+
 void print_usage(char prog_name[])
 {
   cout << "version: " << libIntegrate_FULL_VERSION << "\n\n";
@@ -31,24 +175,88 @@ void print_documentation()
   cout << "Reads function from a file an integrates it."
        << "\n"
        << "The data is contained in a gnuplot-style text file, with each x-y pair on a new line, separated by white space."
+       << "\n"
+       << "Binary NumPy (.npy) and raw float64 files are detected automatically. 1D data is read from the first two columns"
+       << "\n"
+       << "(or the only column), 2D data is read from gnuplot's nonuniform matrix layout."
+       << "\n"
+       << "With --columns, the data may have any number of columns, separated by white space or commas (CSV),"
+       << "\n"
+       << "and an optional header line with the column names."
+       << "\n"
+       << "Text files may be gzip or zstd compressed, they are decompressed as they are read."
+       << "\n"
+       << "With --batch, any number of files may be given (or listed in a file with --file-list), they are integrated"
+       << "\n"
+       << "concurrently and the results are written one file per line, in the order the files were given."
+       << "\n"
+       << "\n"
+       << "With --server or --socket, the program keeps running and integrates requests. Requests and responses are framed"
+       << "\n"
+       << "by a 4-byte little-endian length. A request is a line of options (e.g. '-m simpson -d 2') followed by the data,"
+       << "\n"
+       << "or the options name a file to read instead (e.g. a shared memory object in /dev/shm). The response is 'ok' or"
+       << "\n"
+       << "'error' on the first line, followed by the output or the error messages. Requests larger than 256 MiB are"
+       << "\n"
+       << "refused and the connection is closed, larger data should be passed in a file."
        << "\n";
 }
 
-std::function<double(std::vector<double> &, std::vector<double> &, long, long)> create_1d(std::string type)
+// libInterpolate's interpolators need std::vector's
+const std::vector<double> &as_vector(const std::vector<double> &v, std::vector<double> &)
+{
+  return v;
+}
+
+template<typename C>
+const std::vector<double> &as_vector(const C &c, std::vector<double> &buffer)
+{
+  buffer.resize(libIntegrate::getSize(c));
+  for(size_t i = 0; i < buffer.size(); i++)
+    buffer[i] = libIntegrate::getElement(c, i);
+  return buffer;
+}
+
+// wraps a rule for discretized functions to count the function values it uses for --profile. ranges
+// that are integrated piece by piece (tiles and pipeline chunks) share their boundary points, so the
+// first point of a range is only counted if it is the first point of the data.
+template<typename X, typename Y, typename Rule>
+std::function<double(const X &, const Y &, long, long)> counted(Rule integrate)
+{
+  return [integrate](const X &x, const Y &y, long ai, long bi) {
+    if(profile.enabled) {
+      long N = libIntegrate::getSize(x);
+      ai     = ai < 0 ? ai + N : ai;
+      profile.evaluations += (bi < 0 ? bi + N : bi) - ai + (ai == 0);
+    }
+    return integrate(x, y, ai, bi);
+  };
+}
+
+template<typename X, typename Y>
+std::function<double(const X &, const Y &, long, long)> create_1d(std::string type)
 {
   if(boost::starts_with("riemann", type))
-    return _1D::RiemannRule<double>();
+    return counted<X, Y>(_1D::RiemannRule<double>());
 
   if(boost::starts_with("trapezoid", type))
-    return _1D::TrapezoidRule<double>();
+    return counted<X, Y>(_1D::TrapezoidRule<double>());
 
   if(boost::starts_with("simpson", type))
-    return _1D::SimpsonRule<double>();
+    return counted<X, Y>(_1D::SimpsonRule<double>());
+
+  if(boost::starts_with("spline", type))
+    return counted<X, Y>(_1D::CubicSplineRule<double>());
 
   if(boost::starts_with("gauss-legendre", type))
-    return [](std::vector<double> &x, std::vector<double> &y, long ai, long bi) {
+    return [](const X &x_, const Y &y_, long ai, long bi) {
       // create an interpolator to pass to the integrator
-      _1D::CubicSplineInterpolator<double> interp(x, y);
+      std::vector<double>                  xbuf, ybuf;
+      const std::vector<double>           &x = as_vector(x_, xbuf);
+      const std::vector<double>           &y = as_vector(y_, ybuf);
+      _1D::CubicSplineInterpolator<double> spline(x, y);
+      auto                                 interp = [&spline](double x) { return spline(x); };
 
       while(bi < 0)
         bi += x.size();
@@ -57,16 +265,19 @@ std::function<double(std::vector<double> &, std::vector<double> &, long, long)>
       double max = x[bi];
 
       // we have quadratures of order
-      // 8, 16, 32, and 64.
-      if(bi - ai <= 8) {
+      // 8, 16, 32, and 64, and a quadrature of order n evaluates the interpolant n times.
+      std::size_t order = bi - ai <= 8 ? 8 : bi - ai <= 16 ? 16 : bi - ai <= 32 ? 32 : 64;
+      if(profile.enabled)
+        profile.evaluations += order;
+      if(order == 8) {
         _1D::GQ::GaussLegendreQuadrature<double, 8> integ;
         return integ(interp, min, max);
       }
-      if(bi - ai <= 16) {
+      if(order == 16) {
         _1D::GQ::GaussLegendreQuadrature<double, 16> integ;
         return integ(interp, min, max);
       }
-      if(bi - ai <= 32) {
+      if(order == 32) {
         _1D::GQ::GaussLegendreQuadrature<double, 32> integ;
         return integ(interp, min, max);
       }
@@ -75,10 +286,48 @@ std::function<double(std::vector<double> &, std::vector<double> &, long, long)>
       return integ(interp, min, max);
     };
 
+  if(boost::starts_with("gregory", type))
+    return counted<X, Y>(_1D::GregoryRule<double>());
+
+  return nullptr;
+}
+
+// methods that use all of the points in the range at once (interpolation or end corrections), so
+// the data can't be split into pieces that are integrated separately.
+bool needs_whole_range(std::string type)
+{
+  return boost::starts_with("gauss-legendre", type) || boost::starts_with("spline", type) || boost::starts_with("gregory", type);
+}
+
+// methods that can compute the indefinite integral at every point in one pass.
+template<typename X, typename Y>
+std::function<std::vector<double>(const X &, const Y &)> create_1d_cumulative(std::string type)
+{
+  auto cumulative = [](auto integrate) {
+    return [integrate](const X &x, const Y &y) {
+      if(profile.enabled)
+        profile.evaluations += libIntegrate::getSize(x);
+      return integrate.cumulative(libIntegrate::execution::par, x, y);
+    };
+  };
+
+  if(boost::starts_with("riemann", type))
+    return cumulative(_1D::RiemannRule<double>());
+
+  if(boost::starts_with("trapezoid", type))
+    return cumulative(_1D::TrapezoidRule<double>());
+
+  if(boost::starts_with("simpson", type))
+    return cumulative(_1D::SimpsonRule<double>());
+
+  if(boost::starts_with("spline", type))
+    return cumulative(_1D::CubicSplineRule<double>());
+
   return nullptr;
 }
 
-std::function<double(std::vector<double> &, std::vector<double> &, std::vector<std::vector<double>> &)> create_2d(std::string type)
+template<typename X, typename Y, typename Z>
+std::function<double(const X &, const Y &, const Z &)> create_2d(std::string type)
 {
   if(boost::starts_with("riemann", type))
     return _2D::RiemannRule<double>();
@@ -86,106 +335,877 @@ std::function<double(std::vector<double> &, std::vector<double> &, std::vector<s
     return _2D::TrapezoidRule<double>();
   if(boost::starts_with("simpson", type))
     return _2D::SimpsonRule<double>();
+  if(boost::starts_with("spline", type))
+    return _2D::CubicSplineRule<double>();
+  if(boost::starts_with("gregory", type))
+    return _2D::GregoryRule<double>();
 
   return nullptr;
 }
 
-int main(int argc, char *argv[])
+template<typename X, typename Y>
+int integrate_1d(const po::variables_map &vm, const X &x, const Y &y, std::ostream &out = std::cout)
 {
-  po::options_description options("Allowed options");
-  options.add_options()("help,h", "print help message")("batch,b", "output in 'batch' mode")("dimensions,d", po::value<int>()->default_value(1), "number of dimensions (1 or 2).")("method,m", po::value<string>()->default_value("riemann"), "integration method.")("list,l", "list available integration methods.")("indefinate,i", "compute the indefinate integral g(x) = \\int_a^x f(x') dx'.")("integrate-data", po::value<string>()->default_value("-"), "file containing data to be integrated.");
+  // create integrator
+  auto integrate = create_1d<X, Y>(vm["method"].as<string>());
+  if(!integrate) {
+    cerr << "ERROR: Unrecognized integration method (" << vm["method"].as<string>() << ")." << endl;
+    return 1;
+  }
 
-  po::positional_options_description args;
-  args.add("integrate-data", 1);
+  // integrate
+  if(vm.count("indefinate")) {
+    if(auto cumulative = create_1d_cumulative<X, Y>(vm["method"].as<string>())) {
+      std::vector<double> sum;
+      {
+        auto timer = profile.time("integrate");
+        sum        = cumulative(x, y);
+      }
+      auto timer = profile.time("output");
+      for(size_t n = 1; n < sum.size(); n++)
+        out << libIntegrate::getElement(x, n) << " " << sum[n] << "\n";
+      return 0;
+    }
 
-  po::variables_map vm;
-  po::store(po::command_line_parser(argc, argv).options(options).positional(args).run(), vm);
-  po::notify(vm);
+    auto timer = profile.time("integrate");
+    for(size_t n = 1; n < libIntegrate::getSize(x); n++) {
+      auto sum = integrate(x, y, 0, n);
+      out << libIntegrate::getElement(x, n) << " " << sum << "\n";
+    }
 
-  if(argc == 1 || vm.count("help")) {
-    print_usage(argv[0]);
-    cout << "\n";
-    cout << options << "\n";
-    cout << "\n";
-    print_documentation();
-    cout << "\n";
+  } else {
+    double sum;
+    {
+      auto timer = profile.time("integrate");
+      sum        = integrate(x, y, 0, -1);
+    }
+    auto timer = profile.time("output");
+    out << sum << "\n";
+  }
+  return 0;
+}
+
+template<typename X, typename Y, typename Z>
+int integrate_2d(const po::variables_map &vm, const X &x, const Y &y, const Z &z, std::ostream &out = std::cout)
+{
+  // create integrator
+  auto integrate = create_2d<X, Y, Z>(vm["method"].as<string>());
+  if(!integrate) {
+    cerr << "ERROR: Unrecognized integration method (" << vm["method"].as<string>() << ")." << endl;
     return 1;
   }
 
-  if(vm.count("list")) {
-    cout << "\t'riemann' : simple riemann sum\n";
-    cout << "\t'trapezoid' : trapezoid rule\n";
-    cout << "\t'simpson' : simposon's rule (uses interpolation)\n";
-    cout << "\t'gauss-legendre' : Gauss-Legendre interpolation (uses interpolation)\n";
+  // integrate
+  if(vm.count("indefinate")) {
+    cerr << "ERROR: Indefinate integrals are not supported with 2D integrals (yet)." << std::endl;
     return 1;
   }
+  double sum;
+  {
+    auto timer = profile.time("integrate");
+    sum        = integrate(x, y, z);
+    if(profile.enabled)
+      profile.evaluations += libIntegrate::getSize(x) * libIntegrate::getSize(y);
+  }
+  auto timer = profile.time("output");
+  out << sum << "\n";
+  return 0;
+}
 
-  ifstream in;
+// parses a column selection like "2-4,7,voltage" (1-based column numbers, ranges, or header names)
+// into 0-based column indices. "all" selects every column except the first (x) column.
+std::vector<std::size_t> select_columns(const std::string &spec, const std::vector<std::string> &names, std::size_t ncols)
+{
+  std::vector<std::size_t>                      selected;
+  boost::char_separator<char>                   sep(",");
+  boost::tokenizer<boost::char_separator<char>> tokens(spec, sep);
+  for(const auto &token : tokens) {
+    auto name = std::find(names.begin(), names.end(), token);
+    if(name != names.end()) {
+      selected.push_back(name - names.begin());
+      continue;
+    }
+    if(token == "all") {
+      for(std::size_t j = 1; j < ncols; j++)
+        selected.push_back(j);
+      continue;
+    }
 
-  // open data stream
-  if(vm["integrate-data"].as<string>() == "-") {
-    in.open("/dev/stdin");
-  } else {
-    in.open(vm["integrate-data"].as<string>().c_str());
+    std::size_t first, last;
+    auto        dash = token.find('-', 1);
+    try {
+      first = boost::lexical_cast<std::size_t>(token.substr(0, dash));
+      last  = dash == std::string::npos ? first : boost::lexical_cast<std::size_t>(token.substr(dash + 1));
+    } catch(const boost::bad_lexical_cast &) {
+      throw std::runtime_error("Unrecognized column (" + token + ").");
+    }
+    if(first < 1 || last > ncols || first > last)
+      throw std::runtime_error("Column out of range (" + token + "), the data has " + std::to_string(ncols) + " columns.");
+    for(std::size_t j = first; j <= last; j++)
+      selected.push_back(j - 1);
   }
+  return selected;
+}
 
-  if(!in.is_open()) {
-    cerr << "ERROR: Could not open file: " << vm["integrate-data"].as<string>() << endl;
+// integrate several y columns against a shared x column (the first column). The rows are processed in tiles,
+// and each tile is integrated for all of the columns before moving on, so x is only read from memory once.
+// The tiles have an even number of intervals so that Simpson's rule pairs the intervals the same way as it
+// does for the whole column.
+template<typename X, typename GetColumn>
+int integrate_columns(const po::variables_map &vm, const X &x, GetColumn getColumn, std::size_t ncols, const std::vector<std::string> &names)
+{
+  using Y = std::decay_t<decltype(getColumn(0))>;
+
+  // create integrator
+  auto integrate = create_1d<X, Y>(vm["method"].as<string>());
+  if(!integrate) {
+    cerr << "ERROR: Unrecognized integration method (" << vm["method"].as<string>() << ")." << endl;
+    return 1;
+  }
+  if(vm.count("indefinate")) {
+    cerr << "ERROR: Indefinate integrals are not supported with multiple columns (yet)." << std::endl;
     return 1;
   }
 
-  // load data
-  auto data = libIntegrate::gnuplot::readGnuplotData(in);
+  std::vector<std::size_t> selected;
+  try {
+    selected = select_columns(vm["columns"].as<string>(), names, ncols);
+  } catch(const std::runtime_error &e) {
+    cerr << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+
+  const long N    = libIntegrate::getSize(x);
+  const long tile = needs_whole_range(vm["method"].as<string>()) ? N : 4096;
+
+  std::vector<double> sums(selected.size(), 0);
+  {
+    auto timer = profile.time("integrate");
+    for(long a = 0; a < N - 1; a += tile) {
+      long b = std::min(a + tile, N - 1);
+      for(std::size_t k = 0; k < selected.size(); k++)
+        sums[k] += integrate(x, getColumn(selected[k]), a, b);
+    }
+  }
+
+  auto timer = profile.time("output");
+  for(std::size_t k = 0; k < selected.size(); k++) {
+    std::cout << (names.empty() ? std::to_string(selected[k] + 1) : names[selected[k]]) << " " << sums[k] << "\n";
+  }
+  return 0;
+}
+
+// integrate a memory-mapped binary file through zero-copy views of its columns.
+int integrate_binary(const po::variables_map &vm, const libIntegrate::binary::Array &data, std::ostream &out = std::cout)
+{
+  if(vm.count("columns"))
+    return integrate_columns(vm, data.column(0), [&data](std::size_t j) { return data.column(j); }, data.cols(), {});
 
   if(vm["dimensions"].as<int>() == 1) {
-    // create integrator
-    std::function<double(std::vector<double> &, std::vector<double> &, long, long)> integrate;
-    integrate = create_1d(vm["method"].as<string>());
-    if(!integrate) {
-      cerr << "ERROR: Unrecognized integration method (" << vm["method"].as<string>() << ")." << endl;
-      return 1;
+    if(data.cols() == 1) {
+      // a single column is y, x is the index (same as single column text files)
+      auto n = data.rows();
+      return integrate_1d(vm, _1D::RandomAccessLambda([](long i) { return static_cast<double>(i); }, [n]() { return n; }), data.column(0), out);
+    }
+    return integrate_1d(vm, data.column(0), data.column(1), out);
+  }
+
+  if(vm["dimensions"].as<int>() == 2) {
+    auto m = libIntegrate::binary::nonuniformMatrix(data);
+    return integrate_2d(vm, m.x, m.y, m.z, out);
+  }
+
+  return 0;
+}
+
+// integrate gnuplot-style data that has been loaded into columns.
+int integrate_data(const po::variables_map &vm, const libIntegrate::gnuplot::ColumnarData &data, std::ostream &out = std::cout)
+{
+  if(vm["dimensions"].as<int>() == 1) {
+    // the columns can be integrated directly unless some points are missing values
+    if(data.hasAllXY())
+      return integrate_1d(vm, data.x(), data.y(), out);
+
+    std::vector<double> X, Y;
+    {
+      auto timer = profile.time("extract");
+      libIntegrate::gnuplot::extract(data, X, Y);
     }
+    return integrate_1d(vm, X, Y, out);
+  }
 
+  if(vm["dimensions"].as<int>() == 2) {
     // extract data
     std::vector<double> X, Y;
-    libIntegrate::gnuplot::extract(data, X, Y);
+    _2D::Grid<double>   Z;
+    {
+      auto timer = profile.time("extract grid");
+      libIntegrate::gnuplot::extract(data, X, Y, Z);
+    }
+    return integrate_2d(vm, X, Y, Z, out);
+  }
 
-    // integrate
-    if(vm.count("indefinate")) {
-      for(size_t n = 1; n < X.size(); n++) {
-        auto sum = integrate(X, Y, 0, n);
-        std::cout << X[n] << " " << sum << "\n";
+  return 0;
+}
+
+// integrate data as it is read from the stream, without storing it.
+template<typename Accumulator>
+void stream_1d(std::istream &in, bool indefinate)
+{
+  auto        timer = profile.time("stream");
+  Accumulator acc;
+  libIntegrate::gnuplot::forEachDataPoint(in, [&acc, indefinate](const libIntegrate::gnuplot::DataPoint &p) {
+    if(!p.x.has_value() || !p.y.has_value())
+      return;
+    acc.add(p.x.value(), p.y.value());
+    if(indefinate && acc.size() > 1)
+      std::cout << p.x.value() << " " << acc.value() << "\n";
+  });
+  profile.points += acc.size();
+  if(profile.enabled)
+    profile.evaluations += acc.size();
+  if(!indefinate)
+    std::cout << acc.value() << "\n";
+}
+
+std::function<void(std::istream &, bool)> create_1d_stream(std::string type)
+{
+  if(boost::starts_with("riemann", type))
+    return stream_1d<_1D::RiemannRule<double>::Accumulator>;
+
+  if(boost::starts_with("trapezoid", type))
+    return stream_1d<_1D::TrapezoidRule<double>::Accumulator>;
+
+  if(boost::starts_with("simpson", type))
+    return stream_1d<_1D::SimpsonRule<double>::Accumulator>;
+
+  return nullptr;
+}
+
+// the input file for the single file modes, "-" is stdin.
+std::string input_file(const po::variables_map &vm)
+{
+  return vm.count("integrate-data") ? vm["integrate-data"].as<std::vector<string>>().front() : "-";
+}
+
+// calls f(in) with a stream for the input file (or the standard input stream). compressed files are decompressed as they are read.
+template<typename F>
+int read_input(const po::variables_map &vm, std::istream &input, F f)
+{
+  try {
+    if(input_file(vm) == "-") {
+      f(input);
+      return 0;
+    }
+    libIntegrate::InputFile in(input_file(vm));
+    f(in);
+    in.throwIfError();
+  } catch(const std::runtime_error &e) {
+    cerr << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+  return 0;
+}
+
+// a blocking queue that holds at most `capacity` items.
+template<typename T>
+class BoundedQueue
+{
+ public:
+  explicit BoundedQueue(std::size_t capacity) : m_capacity(capacity) {}
+
+  void push(T item)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return m_items.size() < m_capacity; });
+    m_items.push_back(std::move(item));
+    lock.unlock();
+    m_cv.notify_all();
+  }
+
+  // waits for an item, returns false if the queue is closed and empty.
+  bool pop(T &item)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return !m_items.empty() || m_closed; });
+    if(m_items.empty())
+      return false;
+    item = std::move(m_items.front());
+    m_items.pop_front();
+    lock.unlock();
+    m_cv.notify_all();
+    return true;
+  }
+
+  void close()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_closed = true;
+    }
+    m_cv.notify_all();
+  }
+
+ private:
+  std::size_t             m_capacity;
+  std::deque<T>           m_items;
+  std::mutex              m_mutex;
+  std::condition_variable m_cv;
+  bool                    m_closed = false;
+};
+
+// a fixed-size buffer of parsed points
+struct PointBuffer {
+  std::vector<double> x, y;
+};
+
+// integrate the data with a reader thread that parses fixed-size buffers of points while this thread integrates
+// the previous buffer. Only `buffers` buffers exist and they are reused, so the memory used does not depend on the
+// amount of data, and the parsing and integration overlap.
+double pipeline_1d(std::istream &in, const std::function<double(const std::vector<double> &, const std::vector<double> &, long, long)> &integrate, std::size_t chunkSize, std::size_t buffers)
+{
+  BoundedQueue<PointBuffer> filled(buffers), empty(buffers);
+  for(std::size_t i = 0; i < buffers; i++) {
+    PointBuffer buffer;
+    buffer.x.reserve(chunkSize);
+    buffer.y.reserve(chunkSize);
+    empty.push(std::move(buffer));
+  }
+
+  std::exception_ptr error;
+  std::thread        reader([&]() {
+    try {
+      PointBuffer buffer;
+      empty.pop(buffer);
+      libIntegrate::gnuplot::forEachDataPoint(in, [&](const libIntegrate::gnuplot::DataPoint &p) {
+        if(!p.x.has_value() || !p.y.has_value())
+          return;
+        buffer.x.push_back(p.x.value());
+        buffer.y.push_back(p.y.value());
+        if(buffer.x.size() == chunkSize) {
+          filled.push(std::move(buffer));
+          empty.pop(buffer);
+          buffer.x.clear();
+          buffer.y.clear();
+        }
+      });
+      if(!buffer.x.empty())
+        filled.push(std::move(buffer));
+    } catch(...) {
+      error = std::current_exception();
+    }
+    filled.close();
+  });
+
+  // the window holds the points that have not been integrated yet, starting at index `start`.
+  // each integration ends on an even (global) index so that Simpson's rule pairs the intervals
+  // the same way it would for the whole data set, and the point before `start` is kept because
+  // Simpson's rule uses it for a single interval at the end of the data.
+  std::vector<double> x, y;
+  long                start = 0;
+  double              sum   = 0;
+  PointBuffer         buffer;
+  while(filled.pop(buffer)) {
+    profile.points += buffer.x.size();
+    x.insert(x.end(), buffer.x.begin(), buffer.x.end());
+    y.insert(y.end(), buffer.y.begin(), buffer.y.end());
+    empty.push(std::move(buffer));
+
+    long last = start + 2 * ((static_cast<long>(x.size()) - 1 - start) / 2);
+    if(last > start) {
+      sum += integrate(x, y, start, last);
+      x.erase(x.begin(), x.begin() + last - 1);
+      y.erase(y.begin(), y.begin() + last - 1);
+      start = 1;
+    }
+  }
+  reader.join();
+  if(error)
+    std::rethrow_exception(error);
+
+  if(static_cast<long>(x.size()) - 1 > start)
+    sum += integrate(x, y, start, -1);
+  return sum;
+}
+
+// integrate a single file in batch mode and return the result. errors are thrown so they can be reported for the file.
+std::string integrate_batch_file(const po::variables_map &vm, const std::string &path)
+{
+  // the files are already integrated concurrently, so each one is parsed with a single thread.
+  std::ostringstream out;
+  int                status;
+  count_file_bytes(path);
+  if(libIntegrate::binary::detectFormat(path) != libIntegrate::binary::Format::Text) {
+    libIntegrate::binary::Array array;
+    {
+      auto timer = profile.time("read");
+      array      = libIntegrate::binary::read(path);
+    }
+    profile.points += array.rows();
+    status = integrate_binary(vm, array, out);
+  } else {
+    libIntegrate::gnuplot::ColumnarData data;
+    {
+      auto timer = profile.time("read");
+      data       = libIntegrate::gnuplot::readGnuplotColumnsParallel(path, 1);
+    }
+    profile.points += data.size();
+    status = integrate_data(vm, data, out);
+  }
+  if(status != 0)
+    throw std::runtime_error("Could not integrate data.");
+
+  auto result = out.str();
+  while(!result.empty() && result.back() == '\n')
+    result.pop_back();
+  return result;
+}
+
+// integrate many files on a pool of worker threads. Each worker takes the next file that has not been started,
+// and the results are written as soon as all of the files before them are finished, so the output is one
+// "path<TAB>result" line per file in the same order as the paths. A file that can not be integrated is reported
+// on stderr and its result is written as nan, the rest of the files are still integrated.
+int integrate_batch(const po::variables_map &vm, const std::vector<std::string> &paths)
+{
+  std::string method = vm["method"].as<string>();
+  if(vm.count("indefinate") || vm.count("columns") || vm.count("stream") || vm.count("pipeline")) {
+    cerr << "ERROR: --batch only supports definite integrals of a single column, it can not be combined with --indefinate, --columns, --stream, or --pipeline." << endl;
+    return 1;
+  }
+  // check the method once up front, instead of reporting it for every file.
+  int dimensions = vm["dimensions"].as<int>();
+  if((dimensions == 1 && !create_1d<std::vector<double>, std::vector<double>>(method)) || (dimensions == 2 && !create_2d<std::vector<double>, std::vector<double>, _2D::Grid<double>>(method))) {
+    cerr << "ERROR: Unrecognized integration method (" << method << ")." << endl;
+    return 1;
+  }
+
+  struct Result {
+    bool        done = false;
+    bool        ok   = false;
+    std::string value;
+  };
+  std::vector<Result>      results(paths.size());
+  std::atomic<std::size_t> next{0};
+  std::mutex               mutex;
+  std::condition_variable  cv;
+
+  auto work = [&]() {
+    for(std::size_t i = next++; i < paths.size(); i = next++) {
+      Result result;
+      try {
+        result.value = integrate_batch_file(vm, paths[i]);
+        result.ok    = true;
+      } catch(const std::exception &e) {
+        result.value = e.what();
       }
+      result.done = true;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        results[i] = std::move(result);
+      }
+      cv.notify_all();
+    }
+  };
 
+  std::size_t threads = vm["threads"].as<int>() > 0 ? vm["threads"].as<int>() : std::max(1u, std::thread::hardware_concurrency());
+  threads             = std::min(threads, paths.size());
+  std::vector<std::thread> workers;
+  for(std::size_t t = 0; t < threads; t++)
+    workers.emplace_back(work);
+
+  int status = 0;
+  for(std::size_t i = 0; i < paths.size(); i++) {
+    Result result;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() { return results[i].done; });
+      result = std::move(results[i]);
+    }
+    if(result.ok) {
+      cout << paths[i] << "\t" << result.value << "\n";
     } else {
-      auto sum = integrate(X, Y, 0, -1);
-      std::cout << sum << "\n";
+      cout << paths[i] << "\tnan\n";
+      cerr << "ERROR: " << paths[i] << ": " << result.value << endl;
+      status = 1;
     }
   }
 
-  if(vm["dimensions"].as<int>() == 2) {
-    // create integrator
-    std::function<double(std::vector<double> &, std::vector<double> &, std::vector<std::vector<double>> &)> integrate;
-    integrate = create_2d(vm["method"].as<string>());
+  for(auto &worker : workers)
+    worker.join();
+  return status;
+}
+
+// integrate the input file given in the options, "-" reads the data from `input`.
+int integrate_input(const po::variables_map &vm, std::istream &input)
+{
+  if(input_file(vm) != "-")
+    count_file_bytes(input_file(vm));
+
+  if(vm.count("stream")) {
+    if(vm["dimensions"].as<int>() != 1) {
+      cerr << "ERROR: Streaming is only supported for 1D integrals." << endl;
+      return 1;
+    }
+    auto integrate = create_1d_stream(vm["method"].as<string>());
     if(!integrate) {
-      cerr << "ERROR: Unrecognized integration method (" << vm["method"].as<string>() << ")." << endl;
+      cerr << "ERROR: Unrecognized or unsupported integration method for streaming (" << vm["method"].as<string>() << ")." << endl;
       return 1;
     }
 
-    // extract data
-    std::vector<double>              X, Y;
-    std::vector<std::vector<double>> Z;
-    libIntegrate::gnuplot::extract(data, X, Y, Z);
+    return read_input(vm, input, [&](std::istream &in) { integrate(in, vm.count("indefinate") > 0); });
+  }
 
-    // integrate
+  if(vm.count("pipeline")) {
+    if(vm["dimensions"].as<int>() != 1) {
+      cerr << "ERROR: Pipelining is only supported for 1D integrals." << endl;
+      return 1;
+    }
     if(vm.count("indefinate")) {
-      cerr << "ERROR: Indefinate integrals are not supported with 2D integrals (yet)." << std::endl;
-      return 1
-    } else {
-      auto sum = integrate(X, Y, Z);
-      std::cout << sum << "\n";
+      cerr << "ERROR: Indefinate integrals are not supported with --pipeline (yet)." << endl;
+      return 1;
+    }
+    auto integrate = needs_whole_range(vm["method"].as<string>()) ? nullptr : create_1d<std::vector<double>, std::vector<double>>(vm["method"].as<string>());
+    if(!integrate) {
+      cerr << "ERROR: Unrecognized or unsupported integration method for pipelining (" << vm["method"].as<string>() << ")." << endl;
+      return 1;
+    }
+    if(vm["chunk-size"].as<std::size_t>() == 0 || vm["buffers"].as<std::size_t>() == 0) {
+      cerr << "ERROR: --chunk-size and --buffers must be greater than zero." << endl;
+      return 1;
+    }
+
+    return read_input(vm, input, [&](std::istream &in) {
+      auto timer = profile.time("pipeline");
+      std::cout << pipeline_1d(in, integrate, vm["chunk-size"].as<std::size_t>(), vm["buffers"].as<std::size_t>()) << "\n";
+    });
+  }
+
+  // binary files are integrated in place
+  if(input_file(vm) != "-") {
+    try {
+      if(libIntegrate::binary::detectFormat(input_file(vm)) != libIntegrate::binary::Format::Text) {
+        libIntegrate::binary::Array array;
+        {
+          auto timer = profile.time("read");
+          array      = libIntegrate::binary::read(input_file(vm));
+        }
+        profile.points += array.rows();
+        return integrate_binary(vm, array);
+      }
+    } catch(const std::runtime_error &e) {
+      cerr << "ERROR: " << e.what() << endl;
+      return 1;
     }
   }
 
-  return 0;
+  // multi-column data is read into a table
+  if(vm.count("columns")) {
+    if(vm["dimensions"].as<int>() != 1) {
+      cerr << "ERROR: Multiple columns are only supported for 1D integrals." << endl;
+      return 1;
+    }
+    libIntegrate::gnuplot::Table table;
+    try {
+      auto timer = profile.time("read");
+      if(input_file(vm) == "-") {
+        table = libIntegrate::gnuplot::readTable(input);
+      } else {
+        table = libIntegrate::gnuplot::readTable(input_file(vm));
+      }
+    } catch(const std::runtime_error &e) {
+      cerr << "ERROR: " << e.what() << endl;
+      return 1;
+    }
+    if(table.cols() == 0) {
+      cerr << "ERROR: No data found in file: " << input_file(vm) << endl;
+      return 1;
+    }
+    profile.points += table.rows();
+    return integrate_columns(vm, table.column(0), [&table](std::size_t j) -> const std::vector<double> & { return table.column(j); }, table.cols(), table.names());
+  }
+
+  // load data
+  // regular files are memory-mapped and parsed in place (in parallel), stdin has to be read as a stream.
+  libIntegrate::gnuplot::ColumnarData data;
+  if(input_file(vm) == "-") {
+    if(!input) {
+      cerr << "ERROR: Could not open file: " << input_file(vm) << endl;
+      return 1;
+    }
+    auto timer = profile.time("read");
+    data       = libIntegrate::gnuplot::readGnuplotColumns(input);
+  } else {
+    try {
+      auto timer = profile.time("read");
+      data       = libIntegrate::gnuplot::readGnuplotColumnsParallel(input_file(vm), vm["threads"].as<int>());
+    } catch(const std::runtime_error &e) {
+      cerr << "ERROR: " << e.what() << endl;
+      return 1;
+    }
+  }
+  profile.points += data.size();
+
+  return integrate_data(vm, data);
+}
+
+#if !defined(_WIN32)
+// server mode keeps one process running to integrate many requests, so the start-up cost is only paid once.
+//
+// requests and responses are frames: a 4-byte little-endian length followed by that many bytes.
+// a request is a line of command line options (e.g. "-m simpson -d 2"), terminated by a newline,
+// followed by the data. If the options name an input file (for example a shared memory object like
+// /dev/shm/data.npy), the data is read from the file instead, and binary files are mapped, not copied.
+// the response is "ok\n" followed by the output, or "error\n" followed by the error messages.
+
+// the length is sent by the client, so it is limited before the payload is allocated.
+constexpr std::uint32_t max_frame_size = 256u << 20;
+
+// reads exactly n bytes, returns false if the end of the file is reached first.
+bool read_exactly(int fd, char *buffer, std::size_t n)
+{
+  while(n > 0) {
+    auto count = ::read(fd, buffer, n);
+    if(count < 0 && errno == EINTR)
+      continue;
+    if(count <= 0)
+      return false;
+    buffer += count;
+    n -= count;
+  }
+  return true;
+}
+
+bool write_exactly(int fd, const char *buffer, std::size_t n)
+{
+  while(n > 0) {
+    auto count = ::write(fd, buffer, n);
+    if(count < 0 && errno == EINTR)
+      continue;
+    if(count <= 0)
+      return false;
+    buffer += count;
+    n -= count;
+  }
+  return true;
+}
+
+// reads a frame, throws if the frame is larger than max_frame_size.
+bool read_frame(int fd, std::string &payload)
+{
+  unsigned char bytes[4];
+  if(!read_exactly(fd, reinterpret_cast<char *>(bytes), 4))
+    return false;
+  std::uint32_t size = std::uint32_t(bytes[0]) | std::uint32_t(bytes[1]) << 8 | std::uint32_t(bytes[2]) << 16 | std::uint32_t(bytes[3]) << 24;
+  if(size > max_frame_size)
+    throw std::runtime_error("Request of " + std::to_string(size) + " bytes is larger than the maximum of " + std::to_string(max_frame_size) + " bytes.");
+  payload.resize(size);
+  return read_exactly(fd, payload.data(), payload.size());
+}
+
+bool write_frame(int fd, const std::string &payload)
+{
+  std::uint32_t size     = payload.size();
+  unsigned char bytes[4] = {static_cast<unsigned char>(size), static_cast<unsigned char>(size >> 8), static_cast<unsigned char>(size >> 16), static_cast<unsigned char>(size >> 24)};
+  return write_exactly(fd, reinterpret_cast<const char *>(bytes), 4) && write_exactly(fd, payload.data(), payload.size());
+}
+
+// integrate a single request. requests are handled one at a time, so the output and error messages
+// are captured by redirecting std::cout and std::cerr while the request is integrated.
+std::string serve_request(const po::options_description &options, const po::positional_options_description &args, const std::string &payload)
+{
+  auto               newline = payload.find('\n');
+  std::istringstream header(payload.substr(0, newline));
+  std::istringstream data(newline == std::string::npos ? std::string() : payload.substr(newline + 1));
+
+  std::ostringstream out, err;
+  auto              *coutbuf = cout.rdbuf(out.rdbuf());
+  auto              *cerrbuf = cerr.rdbuf(err.rdbuf());
+
+  int status = 1;
+  try {
+    std::vector<string> tokens{std::istream_iterator<string>(header), std::istream_iterator<string>()};
+    po::variables_map   vm;
+    po::store(po::command_line_parser(tokens).options(options).positional(args).run(), vm);
+    po::notify(vm);
+    if(vm.count("help") || vm.count("list") || vm.count("batch") || vm.count("file-list") || vm.count("server") || vm.count("socket"))
+      cerr << "ERROR: --help, --list, --batch, --file-list, --server, and --socket can not be used in a request." << endl;
+    else if(vm.count("integrate-data") && vm["integrate-data"].as<std::vector<string>>().size() > 1)
+      cerr << "ERROR: A request can only integrate one file." << endl;
+    else
+      status = integrate_input(vm, data);
+  } catch(const std::exception &e) {
+    cerr << "ERROR: " << e.what() << endl;
+  }
+
+  cout.rdbuf(coutbuf);
+  cerr.rdbuf(cerrbuf);
+  return status == 0 ? "ok\n" + out.str() : "error\n" + err.str();
+}
+
+// answer requests from `in` on `out` until the end of the input. if a request can not be read (it is
+// too large, or memory runs out), the error is sent back and the connection is closed, because the
+// rest of the stream can not be trusted.
+void serve_frames(const po::options_description &options, const po::positional_options_description &args, int in, int out)
+{
+  try {
+    std::string payload;
+    while(read_frame(in, payload)) {
+      profile.bytes += payload.size();
+      if(!write_frame(out, serve_request(options, args, payload)))
+        return;
+    }
+  } catch(const std::exception &e) {
+    write_frame(out, std::string("error\nERROR: ") + e.what() + "\n");
+  }
+}
+
+int serve(const po::options_description &options, const po::positional_options_description &args, const po::variables_map &vm)
+{
+  // a client that disconnects early should not stop the server.
+  std::signal(SIGPIPE, SIG_IGN);
+
+  if(!vm.count("socket")) {
+    serve_frames(options, args, STDIN_FILENO, STDOUT_FILENO);
+    return 0;
+  }
+
+  std::string path = vm["socket"].as<string>();
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if(path.size() >= sizeof(address.sun_path)) {
+    cerr << "ERROR: Socket path is too long: " << path << endl;
+    return 1;
+  }
+  std::copy(path.begin(), path.end(), address.sun_path);
+
+  // remove a socket left behind by a previous server, but nothing else.
+  struct stat st;
+  if(::stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+    ::unlink(path.c_str());
+
+  int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if(server < 0 || ::bind(server, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || ::listen(server, 16) != 0) {
+    cerr << "ERROR: Could not listen on socket " << path << ": " << std::strerror(errno) << endl;
+    return 1;
+  }
+
+  // connections are served one after another, each one can send any number of requests.
+  while(true) {
+    int client = ::accept(server, nullptr, nullptr);
+    if(client < 0) {
+      if(errno == EINTR || errno == ECONNABORTED)
+        continue;
+      cerr << "ERROR: Could not accept connection: " << std::strerror(errno) << endl;
+      ::close(server);
+      return 1;
+    }
+    serve_frames(options, args, client, client);
+    ::close(client);
+  }
+}
+#else
+int serve(const po::options_description &options, const po::positional_options_description &args, const po::variables_map &vm)
+{
+  cerr << "ERROR: Server mode is not supported on this platform." << endl;
+  return 1;
+}
+#endif
+// run the integration selected by the options.
+int run(const po::options_description &options, const po::positional_options_description &args, const po::variables_map &vm)
+{
+  if(vm.count("batch")) {
+    std::vector<string> paths;
+    if(vm.count("integrate-data"))
+      paths = vm["integrate-data"].as<std::vector<string>>();
+    if(vm.count("file-list")) {
+      ifstream    file;
+      std::string filename = vm["file-list"].as<string>();
+      if(filename != "-")
+        file.open(filename);
+      std::istream &list = filename == "-" ? std::cin : file;
+      if(filename != "-" && !file.is_open()) {
+        cerr << "ERROR: Could not open file: " << filename << endl;
+        return 1;
+      }
+      std::string line;
+      while(std::getline(list, line)) {
+        if(!line.empty() && line.back() == '\r')
+          line.pop_back();
+        if(!line.empty())
+          paths.push_back(line);
+      }
+    }
+    if(paths.empty()) {
+      cerr << "ERROR: No input files were given for --batch." << endl;
+      return 1;
+    }
+    return integrate_batch(vm, paths);
+  }
+
+  if(vm.count("server") || vm.count("socket"))
+    return serve(options, args, vm);
+
+  if(vm.count("integrate-data") && vm["integrate-data"].as<std::vector<string>>().size() > 1) {
+    cerr << "ERROR: Multiple input files can only be integrated with --batch." << endl;
+    return 1;
+  }
+
+  // "-" reads the data from stdin
+  ifstream          file("/dev/stdin");
+  CountingStreamBuf counter(file.rdbuf());
+  std::istream      input(&counter);
+  if(!file.is_open())
+    input.setstate(std::ios::badbit);
+  return integrate_input(vm, input);
+}
+
+int main(int argc, char *argv[])
+{
+  po::options_description options("Allowed options");
+  options.add_options()("help,h", "print help message")("batch,b", "integrate each of the input files (and the files listed in --file-list) concurrently, and write one 'path<TAB>result' line per file in the same order. Files that can not be integrated are reported on stderr and their result is nan.")("file-list", po::value<string>(), "file containing the paths to integrate with --batch, one per line ('-' reads the list from stdin).")("dimensions,d", po::value<int>()->default_value(1), "number of dimensions (1 or 2).")("method,m", po::value<string>()->default_value("riemann"), "integration method.")("list,l", "list available integration methods.")("indefinate,i", "compute the indefinate integral g(x) = \\int_a^x f(x') dx'.")("stream,s", "integrate the data as it is read, without loading it into memory (1D riemann, trapezoid, and simpson only).")("columns,c", po::value<string>(), "integrate several y columns against the first column in one pass. Columns are selected by number (starting at 1), range, or header name, e.g. '--columns 2-5,7,voltage', or 'all'.")("pipeline,p", "parse and integrate the data concurrently, in fixed-size chunks (1D riemann, trapezoid, and simpson only).")("chunk-size", po::value<std::size_t>()->default_value(1 << 16), "number of points in each chunk with --pipeline.")("buffers", po::value<std::size_t>()->default_value(2), "number of chunks in flight with --pipeline.")("threads,j", po::value<int>()->default_value(0), "number of threads used to parse text files, or to integrate files with --batch (0 uses all available cores).")("server", "integrate requests read from stdin and write the results to stdout, until stdin is closed (see below).")("socket", po::value<string>(), "integrate requests from clients that connect to a Unix domain socket created at the given path (see below).")("profile", po::value<string>(), "report the time spent in each phase (reading, extracting, integrating, and writing the output), the bytes read, points parsed, function evaluations, allocations, and peak memory use, as 'text' or 'json'.")("profile-output", po::value<string>(), "file to write the --profile report to, instead of stderr.")("integrate-data", po::value<std::vector<string>>(), "file(s) containing data to be integrated.");
+
+  po::positional_options_description args;
+  args.add("integrate-data", -1);
+
+  po::variables_map vm;
+  po::store(po::command_line_parser(argc, argv).options(options).positional(args).run(), vm);
+  po::notify(vm);
+
+  if(argc == 1 || vm.count("help")) {
+    print_usage(argv[0]);
+    cout << "\n";
+    cout << options << "\n";
+    cout << "\n";
+    print_documentation();
+    cout << "\n";
+    return 1;
+  }
+
+  if(vm.count("list")) {
+    cout << "\t'riemann' : simple riemann sum\n";
+    cout << "\t'trapezoid' : trapezoid rule\n";
+    cout << "\t'simpson' : simposon's rule (uses interpolation)\n";
+    cout << "\t'spline' : exact integral of a natural (tensor-product in 2D) cubic spline through the data\n";
+    cout << "\t'gauss-legendre' : Gauss-Legendre interpolation (uses interpolation, 1D only)\n";
+    cout << "\t'gregory' : trapezoid rule with Gregory end corrections (requires uniform spacing)\n";
+    return 1;
+  }
+
+  if(vm.count("profile") && vm["profile"].as<string>() != "text" && vm["profile"].as<string>() != "json") {
+    cerr << "ERROR: Unrecognized profile format (" << vm["profile"].as<string>() << "), use 'text' or 'json'." << endl;
+    return 1;
+  }
+
+  profile.enabled = vm.count("profile");
+  int status      = run(options, args, vm);
+
+  if(vm.count("profile")) {
+    if(vm.count("profile-output")) {
+      ofstream out(vm["profile-output"].as<string>());
+      profile.report(out, vm["profile"].as<string>());
+    } else {
+      profile.report(cerr, vm["profile"].as<string>());
+    }
+  }
+  return status;
 }
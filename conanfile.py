@@ -2,13 +2,19 @@ from conan import ConanFile
 
 class Pkg(ConanFile):
     generators = "CMakeDeps", "CMakeToolchain",
-    default_options = {'boost/*:header_only ': ' True'}
+    options = {'with_zlib': [True, False], 'with_zstd': [True, False]}
+    default_options = {'boost/*:header_only ': ' True', 'with_zlib': True, 'with_zstd': True}
     settings = "os", "arch", "compiler", "build_type"
 
     def requirements(self):
         self.requires("boost/1.86.0", force=True)
         self.requires("libinterpolate/2.6.2")
         self.requires("catch2/3.3.1")
+        # optional, for reading compressed data files
+        if self.options.with_zlib:
+            self.requires("zlib/1.3.1")
+        if self.options.with_zstd:
+            self.requires("zstd/1.5.6")
 
     def build_requirements(self):
         pass
@@ -0,0 +1,128 @@
+import argparse
+import math
+import os
+import socket
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def make_data(points, seed):
+    lines = []
+    for i in range(points):
+        x = math.pi * i / (points - 1)
+        lines.append(f"{x} {(1 + seed % 7) * math.sin(x)}")
+    return ("\n".join(lines) + "\n").encode()
+
+
+def frame(payload):
+    return struct.pack("<I", len(payload)) + payload
+
+
+def read_exactly(read, n):
+    data = b""
+    while len(data) < n:
+        chunk = read(n - len(data))
+        if not chunk:
+            raise RuntimeError("The server closed the connection.")
+        data += chunk
+    return data
+
+
+def read_frame(read):
+    (size,) = struct.unpack("<I", read_exactly(read, 4))
+    return read_exactly(read, size).decode()
+
+
+def percentiles(latencies):
+    latencies = sorted(latencies)
+
+    def at(p):
+        return latencies[min(len(latencies) - 1, int(p * len(latencies)))]
+
+    return f"mean {sum(latencies) / len(latencies) * 1e6:9.1f} us   p50 {at(0.5) * 1e6:9.1f} us   p99 {at(0.99) * 1e6:9.1f} us"
+
+
+def stdin_sender(process):
+    def send(data):
+        process.stdin.write(data)
+        process.stdin.flush()
+
+    return send
+
+
+def replay(requests, send, read):
+    latencies = []
+    for header, data in requests:
+        start = time.perf_counter()
+        send(frame(header.encode() + b"\n" + data))
+        response = read_frame(read)
+        latencies.append(time.perf_counter() - start)
+        if not response.startswith("ok\n"):
+            raise RuntimeError(f"Request failed: {response}")
+    return latencies
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replays integration requests against integrate-cli and reports the latency of each request.")
+    parser.add_argument('cli', help='Path to the integrate-cli executable.')
+    parser.add_argument('--requests', type=int, default=1000, help='Number of requests to replay.')
+    parser.add_argument('--points', type=int, default=1000, help='Number of points in each request.')
+    parser.add_argument('--method', default='trapezoid', help='Integration method used by the requests.')
+    parser.add_argument('--processes', type=int, default=100, help='Number of requests to run as separate processes for comparison (0 to skip).')
+    args = parser.parse_args()
+
+    requests = [(f"-m {args.method}", make_data(args.points, i)) for i in range(args.requests)]
+    print(f"{args.requests} requests, {args.points} points each, method '{args.method}'")
+
+    # one process per request, the way the command line tool is normally used.
+    if args.processes > 0:
+        latencies = []
+        for header, data in requests[: args.processes]:
+            start = time.perf_counter()
+            subprocess.run([args.cli] + header.split() + ["-"], input=data, capture_output=True, check=True)
+            latencies.append(time.perf_counter() - start)
+        print(f"process per request: {percentiles(latencies)}")
+
+    # one server process reading requests from stdin.
+    server = subprocess.Popen([args.cli, "--server"], stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+    latencies = replay(requests, stdin_sender(server), server.stdout.read)
+    server.stdin.close()
+    server.wait()
+    print(f"server (stdin):      {percentiles(latencies)}")
+
+    # one server process listening on a Unix socket.
+    with tempfile.TemporaryDirectory() as directory:
+        path = os.path.join(directory, "integrate.sock")
+        server = subprocess.Popen([args.cli, "--socket", path])
+        try:
+            for _ in range(100):
+                if os.path.exists(path):
+                    break
+                time.sleep(0.05)
+            with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as client:
+                client.connect(path)
+                latencies = replay(requests, client.sendall, client.recv)
+            print(f"server (socket):     {percentiles(latencies)}")
+        finally:
+            server.terminate()
+            server.wait()
+
+    # the same data in a shared memory file, so only the options are sent.
+    if os.path.isdir("/dev/shm"):
+        with tempfile.NamedTemporaryFile(dir="/dev/shm", suffix=".txt") as shared:
+            shared.write(requests[0][1])
+            shared.flush()
+            server = subprocess.Popen([args.cli, "--server"], stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+            latencies = replay([(f"-m {args.method} {shared.name}", b"")] * args.requests, stdin_sender(server), server.stdout.read)
+            server.stdin.close()
+            server.wait()
+            print(f"server (/dev/shm):   {percentiles(latencies)}")
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
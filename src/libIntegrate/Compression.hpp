@@ -0,0 +1,375 @@
+#pragma once
+
+/** @file Compression.hpp
+ * @brief Streaming decompression of gzip and zstd compressed input files.
+ *
+ * Decompression support is optional. gzip files can be read if the library is built
+ * with LIBINTEGRATE_HAVE_ZLIB defined (and linked against zlib), zstd files if it
+ * is built with LIBINTEGRATE_HAVE_ZSTD defined (and linked against libzstd). The CMake
+ * target defines these automatically when the libraries are found.
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(LIBINTEGRATE_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(LIBINTEGRATE_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace libIntegrate
+{
+enum class Compression {
+  None,
+  Gzip,  // gzip (or zlib) compressed, detected by the 1f 8b magic bytes
+  Zstd   // zstd compressed, detected by the 28 b5 2f fd magic bytes
+};
+
+// Detects the compression of a file from its first few bytes.
+inline Compression detectCompression(const std::string& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if(!file) {
+    throw std::runtime_error("Failed to open file: " + filename);
+  }
+  unsigned char magic[4] = {0, 0, 0, 0};
+  file.read(reinterpret_cast<char*>(magic), 4);
+  auto n = file.gcount();
+  if(n >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) return Compression::Gzip;
+  if(n >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) return Compression::Zstd;
+  return Compression::None;
+}
+
+/**
+ * Interface for the decompressors. read() decompresses up to n bytes into buffer
+ * and returns the number of bytes written, which is only 0 at the end of the data.
+ * Corrupt or truncated data throws a std::runtime_error.
+ */
+class Decompressor
+{
+ public:
+  virtual ~Decompressor()                               = default;
+  virtual std::size_t read(char* buffer, std::size_t n) = 0;
+};
+
+#if defined(LIBINTEGRATE_HAVE_ZLIB)
+/**
+ * Decompresses gzip files with zlib. Files with several concatenated gzip members
+ * (e.g. from pigz or `cat a.gz b.gz`) are decompressed as a single stream.
+ */
+class GzipDecompressor : public Decompressor
+{
+ public:
+  explicit GzipDecompressor(const std::string& filename) : m_file(filename, std::ios::binary), m_input(1 << 18)
+  {
+    if(!m_file) {
+      throw std::runtime_error("Failed to open file: " + filename);
+    }
+    // 15 + 32: the largest window, and detect the gzip or zlib header automatically
+    if(inflateInit2(&m_stream, 15 + 32) != Z_OK) {
+      throw std::runtime_error("Failed to initialize zlib.");
+    }
+  }
+  ~GzipDecompressor() override { inflateEnd(&m_stream); }
+
+  GzipDecompressor(const GzipDecompressor&)            = delete;
+  GzipDecompressor& operator=(const GzipDecompressor&) = delete;
+
+  std::size_t read(char* buffer, std::size_t n) override
+  {
+    m_stream.next_out  = reinterpret_cast<Bytef*>(buffer);
+    m_stream.avail_out = static_cast<uInt>(n);
+    while(m_stream.avail_out > 0) {
+      if(m_stream.avail_in == 0 && !m_eof) {
+        m_file.read(m_input.data(), m_input.size());
+        m_stream.next_in  = reinterpret_cast<Bytef*>(m_input.data());
+        m_stream.avail_in = static_cast<uInt>(m_file.gcount());
+        m_eof             = m_stream.avail_in == 0;
+      }
+
+      uInt in  = m_stream.avail_in;
+      uInt out = m_stream.avail_out;
+      int  ret = inflate(&m_stream, Z_NO_FLUSH);
+      if(ret == Z_STREAM_END) {
+        // another member may follow
+        m_member = false;
+        inflateReset(&m_stream);
+        continue;
+      }
+      if(ret != Z_OK && ret != Z_BUF_ERROR) {
+        throw std::runtime_error(std::string("Corrupt gzip data: ") + (m_stream.msg ? m_stream.msg : "unknown error"));
+      }
+      if(m_stream.avail_in != in) m_member = true;
+
+      // no more input, and no pending output
+      if(m_eof && m_stream.avail_in == 0 && m_stream.avail_out == out) {
+        if(m_member) {
+          throw std::runtime_error("Truncated gzip data.");
+        }
+        break;
+      }
+    }
+    return n - m_stream.avail_out;
+  }
+
+ private:
+  std::ifstream     m_file;
+  std::vector<char> m_input;
+  z_stream          m_stream{};
+  bool              m_eof    = false;
+  bool              m_member = false;  // true while inside a gzip member
+};
+#endif
+
+#if defined(LIBINTEGRATE_HAVE_ZSTD)
+// Decompresses zstd files (including files with several frames) with libzstd's streaming API.
+class ZstdDecompressor : public Decompressor
+{
+ public:
+  explicit ZstdDecompressor(const std::string& filename) : m_file(filename, std::ios::binary), m_input(ZSTD_DStreamInSize())
+  {
+    if(!m_file) {
+      throw std::runtime_error("Failed to open file: " + filename);
+    }
+    m_stream = ZSTD_createDStream();
+    if(m_stream == nullptr || ZSTD_isError(ZSTD_initDStream(m_stream))) {
+      ZSTD_freeDStream(m_stream);
+      throw std::runtime_error("Failed to initialize zstd.");
+    }
+  }
+  ~ZstdDecompressor() override { ZSTD_freeDStream(m_stream); }
+
+  ZstdDecompressor(const ZstdDecompressor&)            = delete;
+  ZstdDecompressor& operator=(const ZstdDecompressor&) = delete;
+
+  std::size_t read(char* buffer, std::size_t n) override
+  {
+    ZSTD_outBuffer out{buffer, n, 0};
+    while(out.pos < out.size) {
+      if(m_in.pos == m_in.size && !m_eof) {
+        m_file.read(m_input.data(), m_input.size());
+        m_in  = ZSTD_inBuffer{m_input.data(), static_cast<std::size_t>(m_file.gcount()), 0};
+        m_eof = m_in.size == 0;
+      }
+
+      std::size_t in  = m_in.pos;
+      std::size_t pos = out.pos;
+      std::size_t ret = ZSTD_decompressStream(m_stream, &out, &m_in);
+      if(ZSTD_isError(ret)) {
+        throw std::runtime_error(std::string("Corrupt zstd data: ") + ZSTD_getErrorName(ret));
+      }
+      // ZSTD_decompressStream returns 0 once a frame is complete. a call that
+      // makes no progress (e.g. with no input after the last frame) returns the
+      // size of the next frame header instead, so it does not change the state.
+      if(ret == 0) {
+        m_frame = false;
+      } else if(m_in.pos != in || out.pos != pos) {
+        m_frame = true;
+      }
+
+      // no more input, and no pending output
+      if(m_eof && m_in.pos == m_in.size && out.pos == pos) {
+        if(m_frame) {
+          throw std::runtime_error("Truncated zstd data.");
+        }
+        break;
+      }
+    }
+    return out.pos;
+  }
+
+ private:
+  std::ifstream     m_file;
+  std::vector<char> m_input;
+  ZSTD_DStream*     m_stream = nullptr;
+  ZSTD_inBuffer     m_in{nullptr, 0, 0};
+  bool              m_eof   = false;
+  bool              m_frame = false;  // true while inside a zstd frame
+};
+#endif
+
+// Creates a decompressor for a file, throws if support for the compression was not enabled.
+inline std::unique_ptr<Decompressor> makeDecompressor(const std::string& filename, Compression compression)
+{
+  if(compression == Compression::Gzip) {
+#if defined(LIBINTEGRATE_HAVE_ZLIB)
+    return std::make_unique<GzipDecompressor>(filename);
+#else
+    throw std::runtime_error("Cannot read gzip compressed file (libIntegrate was built without zlib): " + filename);
+#endif
+  }
+  if(compression == Compression::Zstd) {
+#if defined(LIBINTEGRATE_HAVE_ZSTD)
+    return std::make_unique<ZstdDecompressor>(filename);
+#else
+    throw std::runtime_error("Cannot read zstd compressed file (libIntegrate was built without zstd): " + filename);
+#endif
+  }
+  throw std::runtime_error("File is not compressed: " + filename);
+}
+
+/**
+ * A stream buffer that decompresses on a background thread.
+ *
+ * The background thread reads ahead up to `blocks` blocks of `blockSize` bytes, so the
+ * decompression overlaps with whatever is reading the stream (e.g. the parsers). Errors
+ * on the background thread end the stream, throwIfError() rethrows them.
+ */
+class ReadAheadStreamBuf : public std::streambuf
+{
+ public:
+  explicit ReadAheadStreamBuf(std::unique_ptr<Decompressor> source, std::size_t blockSize = 1 << 20, std::size_t blocks = 4)
+      : m_source(std::move(source)), m_blockSize(blockSize), m_maxBlocks(blocks)
+  {
+    m_thread = std::thread([this]() { run(); });
+  }
+  ~ReadAheadStreamBuf() override
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+  }
+
+  ReadAheadStreamBuf(const ReadAheadStreamBuf&)            = delete;
+  ReadAheadStreamBuf& operator=(const ReadAheadStreamBuf&) = delete;
+
+  void throwIfError() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_error) std::rethrow_exception(m_error);
+  }
+
+ protected:
+  int_type underflow() override
+  {
+    if(gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if(!m_current.empty()) m_free.push_back(std::move(m_current));
+    m_current.clear();
+    m_cv.wait(lock, [this]() { return !m_ready.empty() || m_done; });
+    if(m_ready.empty()) {
+      setg(nullptr, nullptr, nullptr);
+      return traits_type::eof();
+    }
+    m_current = std::move(m_ready.front());
+    m_ready.pop_front();
+    lock.unlock();
+    m_cv.notify_all();
+
+    setg(m_current.data(), m_current.data(), m_current.data() + m_current.size());
+    return traits_type::to_int_type(*gptr());
+  }
+
+ private:
+  void run()
+  {
+    try {
+      while(true) {
+        std::vector<char> block;
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          m_cv.wait(lock, [this]() { return m_stop || m_ready.size() < m_maxBlocks; });
+          if(m_stop) break;
+          if(!m_free.empty()) {
+            block = std::move(m_free.back());
+            m_free.pop_back();
+          }
+        }
+
+        block.resize(m_blockSize);
+        std::size_t n = 0;
+        while(n < block.size()) {
+          std::size_t r = m_source->read(block.data() + n, block.size() - n);
+          if(r == 0) break;
+          n += r;
+        }
+        if(n == 0) break;
+        block.resize(n);
+
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_ready.push_back(std::move(block));
+        }
+        m_cv.notify_all();
+      }
+    } catch(...) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_error = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_done = true;
+    }
+    m_cv.notify_all();
+  }
+
+  std::unique_ptr<Decompressor> m_source;
+  std::size_t                   m_blockSize;
+  std::size_t                   m_maxBlocks;
+
+  mutable std::mutex            m_mutex;
+  std::condition_variable       m_cv;
+  std::deque<std::vector<char>> m_ready;
+  std::vector<std::vector<char>> m_free;
+  std::vector<char>             m_current;
+  std::exception_ptr            m_error;
+  bool                          m_stop = false;
+  bool                          m_done = false;
+  std::thread                   m_thread;
+};
+
+/**
+ * An input file stream that transparently decompresses gzip and zstd compressed files.
+ * Uncompressed files are read directly.
+ *
+ * Decompression errors end the stream (like any other read error), call throwIfError()
+ * after reading to find out if the data was corrupt or truncated.
+ */
+class InputFile : public std::istream
+{
+ public:
+  explicit InputFile(const std::string& filename) : std::istream(nullptr), m_compression(detectCompression(filename))
+  {
+    if(m_compression == Compression::None) {
+      if(!m_file.open(filename, std::ios::in | std::ios::binary)) {
+        throw std::runtime_error("Failed to open file: " + filename);
+      }
+      rdbuf(&m_file);
+    } else {
+      m_decompressed = std::make_unique<ReadAheadStreamBuf>(makeDecompressor(filename, m_compression));
+      rdbuf(m_decompressed.get());
+    }
+  }
+
+  Compression compression() const { return m_compression; }
+
+  void throwIfError() const
+  {
+    if(m_decompressed) m_decompressed->throwIfError();
+  }
+
+ private:
+  Compression                         m_compression;
+  std::filebuf                        m_file;
+  std::unique_ptr<ReadAheadStreamBuf> m_decompressed;
+};
+
+}  // namespace libIntegrate
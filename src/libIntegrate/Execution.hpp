@@ -0,0 +1,149 @@
+#pragma once
+
+/** @file Execution.hpp
+ * @brief Execution policies and parallel loop helpers used by libIntegrate
+ */
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace libIntegrate
+{
+/**
+ * Execution policies select between a serial and a parallel implementation of
+ * algorithms that support both, similar to the std::execution policies.
+ *
+ * The parallel implementations use OpenMP. If the code is not compiled with
+ * OpenMP support, libIntegrate::execution::par runs serially.
+ */
+namespace execution
+{
+struct sequenced_policy {
+};
+struct parallel_policy {
+};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy  par{};
+
+template<typename P>
+struct is_execution_policy : std::false_type {
+};
+template<>
+struct is_execution_policy<sequenced_policy> : std::true_type {
+};
+template<>
+struct is_execution_policy<parallel_policy> : std::true_type {
+};
+
+template<typename P>
+inline constexpr bool is_execution_policy_v = is_execution_policy<std::decay_t<P>>::value;
+}  // namespace execution
+
+namespace detail
+{
+/**
+ * Call f(i) for each i in [begin,end).
+ */
+template<typename F>
+void forEachIndex(execution::sequenced_policy, long begin, long end, F&& f)
+{
+  for(long i = begin; i < end; ++i) f(i);
+}
+
+template<typename F>
+void forEachIndex(execution::parallel_policy, long begin, long end, F&& f)
+{
+#pragma omp parallel for schedule(static)
+  for(long i = begin; i < end; ++i) f(i);
+}
+
+/**
+ * The number of elements in each block of blockedSum and inclusiveScan.
+ *
+ * The blocks do not depend on the number of threads, and the block results
+ * are always combined in the same order, so the seq and par versions give
+ * bitwise identical results for any number of threads.
+ */
+inline constexpr long reductionBlockSize = 1L << 15;
+
+/**
+ * Compute f(b,e) for consecutive blocks [b,e) of [begin,end) that contain
+ * reductionBlockSize elements (except the last), and return the sum of
+ * the results, added in order. f returns a summation accumulator
+ * (see Summation.hpp), the sum is the accumulator of all blocks.
+ */
+template<typename A, typename P, typename F>
+A blockedSum(P policy, long begin, long end, F&& f)
+{
+  const long B = reductionBlockSize;
+  const long n = end > begin ? (end - begin + B - 1) / B : 0;
+  if(n <= 1) return n == 1 ? f(begin, end) : A();
+
+  std::vector<A> partial(n);
+  forEachIndex(policy, 0, n, [&](long k) {
+    long b     = begin + k * B;
+    partial[k] = f(b, b + B < end ? b + B : end);
+  });
+
+  A sum;
+  for(const auto& p : partial) sum.add(p);
+  return sum;
+}
+
+/**
+ * Replace each element of v with the sum of itself and all elements before it.
+ *
+ * Each block of reductionBlockSize elements is summed from zero, and the
+ * total of all previous blocks is added to each element, the same way as
+ * the parallel version.
+ */
+template<typename T>
+void inclusiveScan(execution::sequenced_policy, std::vector<T>& v)
+{
+  const long N      = v.size();
+  T          offset = 0;
+  for(long b = 0; b < N; b += reductionBlockSize) {
+    const long e   = b + reductionBlockSize < N ? b + reductionBlockSize : N;
+    T          sum = 0;
+    for(long i = b; i < e; ++i) {
+      sum += v[i];
+      v[i] = offset + sum;
+    }
+    offset += sum;
+  }
+}
+
+/**
+ * Parallel version of inclusiveScan. The blocks are scanned in parallel,
+ * then the block totals are scanned and added back to each block, so the
+ * vector is read twice instead of once.
+ */
+template<typename T>
+void inclusiveScan(execution::parallel_policy, std::vector<T>& v)
+{
+  const long N = v.size();
+  const long B = reductionBlockSize;
+  const long n = (N + B - 1) / B;
+  if(n <= 1) {
+    inclusiveScan(execution::seq, v);
+    return;
+  }
+
+  std::vector<T> offsets(n + 1, T(0));
+  forEachIndex(execution::par, 0, n, [&](long k) {
+    const long e = (k + 1) * B < N ? (k + 1) * B : N;
+    for(long i = k * B + 1; i < e; ++i) v[i] += v[i - 1];
+    offsets[k + 1] = v[e - 1];
+  });
+  for(long k = 1; k <= n; ++k) offsets[k] += offsets[k - 1];
+  forEachIndex(execution::par, 1, n, [&](long k) {
+    const long e = (k + 1) * B < N ? (k + 1) * B : N;
+    for(long i = k * B; i < e; ++i) v[i] = offsets[k] + v[i];
+  });
+}
+
+}  // namespace detail
+
+}  // namespace libIntegrate
@@ -7,19 +7,139 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <charconv>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <istream>
-#include <map>
+#include <iterator>
+#include <limits>
 #include <optional>
-#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <system_error>
+#include <utility>
 #include <vector>
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "./Compression.hpp"
+#include "./_2D/Grid.hpp"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace libIntegrate
 {
+/**
+ * A read-only view of a file's contents that is backed by a memory map.
+ *
+ * The file is mapped when the object is constructed and unmapped when it is
+ * destroyed, so pointers returned by data(), begin() and end() are only valid
+ * while the object is alive. On platforms without mmap the file is read into
+ * a buffer instead.
+ */
+class MappedFile
+{
+ public:
+  MappedFile() = default;
+
+  explicit MappedFile(const std::string& filename)
+  {
+#if defined(_WIN32)
+    std::ifstream file(filename, std::ios::binary);
+    if(!file) {
+      throw std::runtime_error("Failed to open file: " + filename);
+    }
+    m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd < 0) {
+      throw std::runtime_error("Failed to open file: " + filename);
+    }
+    struct stat st;
+    if(::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw std::runtime_error("Failed to stat file: " + filename);
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    // mmap does not accept zero-length mappings, an empty file is just an empty view.
+    if(m_size > 0) {
+      void* addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(addr == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Failed to memory-map file: " + filename);
+      }
+      ::madvise(addr, m_size, MADV_SEQUENTIAL);
+      m_data = static_cast<const char*>(addr);
+    }
+    ::close(fd);
+#endif
+  }
+
+  ~MappedFile() { unmap(); }
+
+  MappedFile(const MappedFile&)            = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  MappedFile(MappedFile&& other) noexcept { swap(other); }
+  MappedFile& operator=(MappedFile&& other) noexcept
+  {
+    if(this != &other) {
+      unmap();
+      swap(other);
+    }
+    return *this;
+  }
+
+  const char* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  const char* begin() const { return m_data; }
+  const char* end() const { return m_data + m_size; }
+
+ private:
+  const char* m_data = nullptr;
+  std::size_t m_size = 0;
+#if defined(_WIN32)
+  std::string m_buffer;
+#endif
+
+  void swap(MappedFile& other) noexcept
+  {
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+#if defined(_WIN32)
+    std::swap(m_buffer, other.m_buffer);
+    m_data = m_buffer.data();
+    other.m_data = other.m_buffer.data();
+#endif
+  }
+
+  void unmap()
+  {
+#if !defined(_WIN32)
+    if(m_data != nullptr) {
+      ::munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+  }
+};
+
 namespace gnuplot
 {
 
@@ -29,6 +149,154 @@ struct DataPoint {
   std::optional<double> z;
 };
 
+/**
+ * Structure-of-arrays storage for gnuplot data.
+ *
+ * The x, y, and z values are stored in separate, contiguous columns, so the columns
+ * can be passed directly to the integrators without copying them with extract(). A
+ * bitmap records which values are present, missing values are stored as NaN.
+ *
+ * The z column is only allocated once a point with a z value is added, so z() is
+ * empty for 1D data.
+ */
+class ColumnarData
+{
+ public:
+  ColumnarData() = default;
+
+  /**
+   * Builds the data from columns that use NaN for missing values. `z` may be empty
+   * if none of the points have a z value, otherwise all columns must be the same size.
+   */
+  ColumnarData(std::vector<double> x, std::vector<double> y, std::vector<double> z = {})
+      : m_x(std::move(x)), m_y(std::move(y)), m_z(std::move(z))
+  {
+    if(m_y.size() != m_x.size() || (!m_z.empty() && m_z.size() != m_x.size())) {
+      throw std::invalid_argument("ColumnarData columns must all be the same size.");
+    }
+    m_present.reserve(3 * m_x.size());
+    for(std::size_t i = 0; i < m_x.size(); ++i) {
+      m_present.push_back(m_x[i] == m_x[i]);
+      m_present.push_back(m_y[i] == m_y[i]);
+      m_present.push_back(!m_z.empty() && m_z[i] == m_z[i]);
+      m_missingX += m_x[i] != m_x[i];
+      m_missingY += m_y[i] != m_y[i];
+    }
+  }
+
+  std::size_t size() const { return m_x.size(); }
+  bool        empty() const { return m_x.empty(); }
+
+  void reserve(std::size_t n)
+  {
+    m_x.reserve(n);
+    m_y.reserve(n);
+    m_present.reserve(3 * n);
+  }
+
+  void clear()
+  {
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_present.clear();
+    m_missingX = m_missingY = 0;
+  }
+
+  void push_back(const DataPoint& p)
+  {
+    std::size_t i = size();
+    m_x.push_back(p.x.value_or(std::numeric_limits<double>::quiet_NaN()));
+    m_y.push_back(p.y.value_or(std::numeric_limits<double>::quiet_NaN()));
+    if(p.z.has_value() || !m_z.empty()) {
+      // the first z value allocates the column for as many points as x
+      if(m_z.empty()) m_z.reserve(m_x.capacity());
+      m_z.resize(i, std::numeric_limits<double>::quiet_NaN());
+      m_z.push_back(p.z.value_or(std::numeric_limits<double>::quiet_NaN()));
+    }
+
+    m_present.push_back(p.x.has_value());
+    m_present.push_back(p.y.has_value());
+    m_present.push_back(p.z.has_value());
+    m_missingX += !p.x.has_value();
+    m_missingY += !p.y.has_value();
+  }
+
+  DataPoint operator[](std::size_t i) const
+  {
+    DataPoint p;
+    if(hasX(i)) p.x = m_x[i];
+    if(hasY(i)) p.y = m_y[i];
+    if(hasZ(i)) p.z = m_z[i];
+    return p;
+  }
+
+  const std::vector<double>& x() const { return m_x; }
+  const std::vector<double>& y() const { return m_y; }
+  const std::vector<double>& z() const { return m_z; }
+
+  bool hasX(std::size_t i) const { return m_present[3 * i]; }
+  bool hasY(std::size_t i) const { return m_present[3 * i + 1]; }
+  bool hasZ(std::size_t i) const { return m_present[3 * i + 2]; }
+
+  // true if every point has both an x and a y value, in which case the x() and y()
+  // columns can be integrated directly.
+  bool hasAllXY() const { return m_missingX == 0 && m_missingY == 0; }
+
+ private:
+  std::vector<double> m_x;
+  std::vector<double> m_y;
+  std::vector<double> m_z;
+  std::vector<bool>   m_present;  // three bits (x,y,z) per point
+  std::size_t         m_missingX = 0;
+  std::size_t         m_missingY = 0;
+};
+
+/**
+ * Storage for data files with any number of columns, e.g. many y columns
+ * that share one x column. Each column is stored in its own contiguous vector,
+ * so columns can be passed directly to the integrators. Missing values are NaN.
+ *
+ * If the file had a header line, names() holds the column names, otherwise it is empty.
+ */
+class Table
+{
+ public:
+  Table() = default;
+  explicit Table(std::size_t cols) : m_columns(cols) {}
+  explicit Table(std::vector<std::string> names) : m_names(std::move(names)), m_columns(m_names.size()) {}
+
+  std::size_t rows() const { return m_columns.empty() ? 0 : m_columns[0].size(); }
+  std::size_t cols() const { return m_columns.size(); }
+  bool        empty() const { return rows() == 0; }
+
+  const std::vector<double>&      column(std::size_t j) const { return m_columns[j]; }
+  const std::vector<std::string>& names() const { return m_names; }
+
+  // the index of the column with the given name, or cols() if there is no such column.
+  std::size_t find(const std::string& name) const
+  {
+    return static_cast<std::size_t>(std::find(m_names.begin(), m_names.end(), name) - m_names.begin());
+  }
+
+  void reserve(std::size_t rows)
+  {
+    for(auto& c : m_columns) c.reserve(rows);
+  }
+
+  // appends a row. Missing values at the end of the row are NaN, extra values are ignored.
+  void push_back(const std::vector<double>& row)
+  {
+    std::size_t n = std::min(row.size(), m_columns.size());
+    for(std::size_t j = 0; j < n; ++j) m_columns[j].push_back(row[j]);
+    for(std::size_t j = n; j < m_columns.size(); ++j) m_columns[j].push_back(std::numeric_limits<double>::quiet_NaN());
+  }
+
+ private:
+  std::vector<std::string>         m_names;
+  std::vector<std::vector<double>> m_columns;
+};
+
 // Core parser: reads from any input stream
 inline std::vector<DataPoint> readGnuplotData(std::istream& input)
 {
@@ -69,14 +337,529 @@ inline std::vector<DataPoint> readGnuplotData(std::istream& input)
   return data;
 }
 
-// Convenience wrapper: opens file and delegates to stream-based parser
+// Convenience wrapper: opens file (decompressing it if needed) and delegates to stream-based parser
 inline std::vector<DataPoint> readGnuplotData(const std::string& filename)
 {
-  std::ifstream file(filename);
-  if(!file) {
-    throw std::runtime_error("Failed to open file: " + filename);
+  InputFile file(filename);
+  auto      data = readGnuplotData(file);
+  file.throwIfError();
+  return data;
+}
+
+namespace detail
+{
+inline bool isBlank(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * Parses the white space separated numbers at the beginning of a line, stopping
+ * at the first token that is not a number (just like `istream >> double` does).
+ * Calls f(value, i) for the i'th number and returns the number of values parsed.
+ */
+template<typename F>
+inline std::size_t forEachNumber(const char* p, const char* end, F&& f)
+{
+  std::size_t n = 0;
+  while(true) {
+    while(p != end && isBlank(*p)) ++p;
+    if(p == end) break;
+
+    // from_chars does not accept a leading '+', but it does accept
+    // inf and nan, which operator>> does not.
+    const char* q = p;
+    if(*q == '+') ++q;
+    const char* d = (q != end && *q == '-') ? q + 1 : q;
+    if(d == end || !(std::isdigit(static_cast<unsigned char>(*d)) || *d == '.')) break;
+
+    double val;
+    auto   result = std::from_chars(q, end, val);
+    if(result.ec != std::errc()) break;
+
+    f(val, n);
+    ++n;
+    p = result.ptr;
+  }
+  return n;
+}
+
+/**
+ * Parses the numbers at the beginning of a line (see forEachNumber).
+ *
+ * The first N values are stored in `values`, but all values on the line are counted,
+ * so the return value may be larger than N.
+ */
+template<std::size_t N>
+inline std::size_t parseLine(const char* p, const char* end, std::array<double, N>& values)
+{
+  return forEachNumber(p, end, [&values](double val, std::size_t i) {
+    if(i < N) values[i] = val;
+  });
+}
+
+/**
+ * Calls f(values, n) for each line in [begin,end) that contains data.
+ * Blank lines and lines beginning with '#' are skipped.
+ */
+template<typename F>
+inline void forEachDataLine(const char* begin, const char* end, F&& f)
+{
+  std::array<double, 3> values;
+  const char*           line = begin;
+  while(line < end) {
+    const char* eol = static_cast<const char*>(std::memchr(line, '\n', end - line));
+    if(eol == nullptr) eol = end;
+
+    const char* start = line;
+    while(start != eol && (*start == ' ' || *start == '\t')) ++start;
+    if(start != eol && *start != '#') {
+      std::size_t n = parseLine(start, eol, values);
+      if(n > 0) f(values, n);
+    }
+
+    if(eol == end) break;
+    line = eol + 1;
+  }
+}
+
+/**
+ * Builds a DataPoint from the values parsed from a line. Single column lines
+ * use (and increment) `index` for the x value.
+ */
+inline DataPoint makeDataPoint(const std::array<double, 3>& values, std::size_t n, std::size_t& index)
+{
+  DataPoint point;
+  if(n == 1) {
+    point.x = static_cast<double>(index++);
+    point.y = values[0];
+  } else if(n == 2) {
+    point.x = values[0];
+    point.y = values[1];
+  } else if(n == 3) {
+    point.x = values[0];
+    point.y = values[1];
+    point.z = values[2];
+  }
+  return point;
+}
+}  // namespace detail
+
+// Zero-copy parser: parses numbers directly out of an in-memory buffer (e.g. a
+// memory-mapped file) with std::from_chars, without any per-line allocations.
+// The results are the same as the stream-based parser.
+inline std::vector<DataPoint> readGnuplotData(const char* begin, const char* end)
+{
+  std::vector<DataPoint> data;
+  data.reserve(std::count(begin, end, '\n') + 1);
+  std::size_t index = 0;
+
+  detail::forEachDataLine(begin, end, [&](const std::array<double, 3>& values, std::size_t n) {
+    data.push_back(detail::makeDataPoint(values, n, index));
+  });
+
+  return data;
+}
+
+// Streaming parser: calls f(point) for each DataPoint in the stream as it is read.
+// The stream is read in fixed size blocks, so memory use does not depend on the
+// amount of data (only on the length of the longest line).
+template<typename F>
+inline void forEachDataPoint(std::istream& input, F&& f)
+{
+  std::vector<char> buffer(1 << 16);
+  std::size_t       size  = 0;
+  std::size_t       index = 0;
+  auto              emit  = [&](const std::array<double, 3>& values, std::size_t n) {
+    f(detail::makeDataPoint(values, n, index));
+  };
+
+  while(input) {
+    if(size == buffer.size()) {
+      // a single line does not fit in the buffer
+      buffer.resize(2 * buffer.size());
+    }
+    input.read(buffer.data() + size, buffer.size() - size);
+    size += static_cast<std::size_t>(input.gcount());
+
+    // parse all complete lines and move the partial line at the end to the front of the buffer
+    const char* begin = buffer.data();
+    const char* last  = begin + size;
+    while(last != begin && *(last - 1) != '\n') --last;
+    detail::forEachDataLine(begin, last, emit);
+    size = static_cast<std::size_t>(begin + size - last);
+    std::memmove(buffer.data(), last, size);
+  }
+  detail::forEachDataLine(buffer.data(), buffer.data() + size, emit);
+}
+
+namespace detail
+{
+/**
+ * Reads an uncompressed file by memory-mapping it and calling `parse(begin, end)`.
+ * Compressed files can't be mapped, they are decompressed on a background thread
+ * while `read(stream)` parses the decompressed stream.
+ */
+template<typename Parse, typename Read>
+inline auto readFile(const std::string& filename, Parse&& parse, Read&& read) -> decltype(parse(nullptr, nullptr))
+{
+  if(detectCompression(filename) == Compression::None) {
+    MappedFile file(filename);
+    return parse(file.begin(), file.end());
+  }
+  InputFile in(filename);
+  auto      data = read(in);
+  in.throwIfError();
+  return data;
+}
+
+inline std::vector<DataPoint> readDataPoints(std::istream& input)
+{
+  std::vector<DataPoint> data;
+  forEachDataPoint(input, [&data](const DataPoint& p) { data.push_back(p); });
+  return data;
+}
+}  // namespace detail
+
+// Memory-maps the file and parses it in place. Compressed files are parsed as they are decompressed.
+inline std::vector<DataPoint> readGnuplotDataMapped(const std::string& filename)
+{
+  return detail::readFile(
+      filename, [](const char* begin, const char* end) { return readGnuplotData(begin, end); }, detail::readDataPoints);
+}
+
+// Columnar parsers: the same as the parsers above, but the data is stored in a ColumnarData.
+// Lines with more than three values carry no usable data and are skipped.
+inline ColumnarData readGnuplotColumns(const char* begin, const char* end)
+{
+  ColumnarData data;
+  data.reserve(std::count(begin, end, '\n') + 1);
+  std::size_t index = 0;
+
+  detail::forEachDataLine(begin, end, [&](const std::array<double, 3>& values, std::size_t n) {
+    if(n <= 3) data.push_back(detail::makeDataPoint(values, n, index));
+  });
+
+  return data;
+}
+
+inline ColumnarData readGnuplotColumns(std::istream& input)
+{
+  ColumnarData data;
+  forEachDataPoint(input, [&data](const DataPoint& p) {
+    if(p.x.has_value()) data.push_back(p);
+  });
+  return data;
+}
+
+// Memory-maps the file and parses it in place. Compressed files are parsed as they are decompressed.
+inline ColumnarData readGnuplotColumns(const std::string& filename)
+{
+  return detail::readFile(
+      filename, [](const char* begin, const char* end) { return readGnuplotColumns(begin, end); }, [](std::istream& in) { return readGnuplotColumns(in); });
+}
+
+namespace detail
+{
+// The number of threads to use for a requested thread count, 0 requests OpenMP's default.
+inline int threadCount(int threads)
+{
+#if defined(_OPENMP)
+  return threads > 0 ? threads : omp_get_max_threads();
+#else
+  (void)threads;
+  return 1;
+#endif
+}
+
+/**
+ * Splits [begin,end) into chunks of roughly `chunkSize` bytes that all start at the
+ * beginning of a line. Returns the chunk boundaries, including begin and end.
+ */
+inline std::vector<const char*> splitLines(const char* begin, const char* end, std::size_t chunkSize)
+{
+  std::vector<const char*> bounds{begin};
+  chunkSize = std::max<std::size_t>(chunkSize, 1);
+  while(static_cast<std::size_t>(end - bounds.back()) > chunkSize) {
+    const char* p   = bounds.back() + chunkSize;
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    if(eol == nullptr || eol + 1 == end) break;
+    bounds.push_back(eol + 1);
+  }
+  bounds.push_back(end);
+  return bounds;
+}
+
+/**
+ * The points parsed from one chunk of a file. Single column lines are numbered
+ * from zero within the chunk, `implicit` records their positions so that they can
+ * be renumbered once the number of single column lines in the previous chunks is known.
+ */
+template<typename Points>
+struct ParsedChunk {
+  Points                   points;
+  std::vector<std::size_t> implicit;
+};
+
+/**
+ * Parses the chunks of [begin,end) in parallel on `threads` threads (if OpenMP is enabled).
+ * `parse(values, n, chunk)` is called for each data line in a chunk. Returns the parsed chunks
+ * and the implicit index offset of each chunk.
+ */
+template<typename Points, typename F>
+inline std::pair<std::vector<ParsedChunk<Points>>, std::vector<std::size_t>> parseChunks(const char* begin, const char* end, int threads, std::size_t chunkSize, F parse)
+{
+  const std::vector<const char*>   bounds = splitLines(begin, end, chunkSize);
+  const long                       N      = static_cast<long>(bounds.size()) - 1;
+  std::vector<ParsedChunk<Points>> chunks(N);
+
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+  for(long k = 0; k < N; ++k) {
+    detail::forEachDataLine(bounds[k], bounds[k + 1], [&chunk = chunks[k], &parse](const std::array<double, 3>& values, std::size_t n) {
+      parse(values, n, chunk);
+    });
+  }
+
+  std::vector<std::size_t> offsets(N + 1, 0);
+  for(long k = 0; k < N; ++k) offsets[k + 1] = offsets[k] + chunks[k].implicit.size();
+  return {std::move(chunks), std::move(offsets)};
+}
+}  // namespace detail
+
+/**
+ * Multi-threaded parser: splits the buffer into chunks at line boundaries and parses
+ * the chunks in parallel with OpenMP. The chunks are merged in order, so the results
+ * are the same as the serial parser, including the x values of single column lines.
+ *
+ * `threads` is the number of threads to use (0 uses OpenMP's default) and `chunkSize` is the
+ * approximate number of bytes in each chunk. Without OpenMP the chunks are parsed serially.
+ */
+inline std::vector<DataPoint> readGnuplotDataParallel(const char* begin, const char* end, int threads = 0, std::size_t chunkSize = 1 << 20)
+{
+  threads     = detail::threadCount(threads);
+  auto parsed = detail::parseChunks<std::vector<DataPoint>>(begin, end, threads, chunkSize, [](const std::array<double, 3>& values, std::size_t n, auto& chunk) {
+    std::size_t index = chunk.implicit.size();
+    if(n == 1) chunk.implicit.push_back(chunk.points.size());
+    chunk.points.push_back(detail::makeDataPoint(values, n, index));
+  });
+
+  const auto&              chunks  = parsed.first;
+  const auto&              offsets = parsed.second;
+  const long               N       = static_cast<long>(chunks.size());
+  std::vector<std::size_t> starts(N + 1, 0);
+  for(long k = 0; k < N; ++k) starts[k + 1] = starts[k] + chunks[k].points.size();
+
+  std::vector<DataPoint> data(starts[N]);
+#pragma omp parallel for num_threads(threads)
+  for(long k = 0; k < N; ++k) {
+    DataPoint* out = data.data() + starts[k];
+    std::copy(chunks[k].points.begin(), chunks[k].points.end(), out);
+    for(std::size_t i : chunks[k].implicit) out[i].x = out[i].x.value() + offsets[k];
+  }
+  return data;
+}
+
+// Multi-threaded columnar parser, see readGnuplotDataParallel().
+// Lines with more than three values carry no usable data and are skipped.
+inline ColumnarData readGnuplotColumnsParallel(const char* begin, const char* end, int threads = 0, std::size_t chunkSize = 1 << 20)
+{
+  struct Columns {
+    std::vector<double> x, y, z;
+  };
+  constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+  threads     = detail::threadCount(threads);
+  auto parsed = detail::parseChunks<Columns>(begin, end, threads, chunkSize, [](const std::array<double, 3>& values, std::size_t n, auto& chunk) {
+    if(n > 3) return;
+    Columns& c = chunk.points;
+    if(n == 1) {
+      c.x.push_back(static_cast<double>(chunk.implicit.size()));
+      c.y.push_back(values[0]);
+      chunk.implicit.push_back(c.y.size() - 1);
+    } else {
+      c.x.push_back(values[0]);
+      c.y.push_back(values[1]);
+    }
+    if(n == 3) {
+      c.z.resize(c.x.size() - 1, std::numeric_limits<double>::quiet_NaN());
+      c.z.push_back(values[2]);
+    }
+  });
+
+  const auto&              chunks  = parsed.first;
+  const auto&              offsets = parsed.second;
+  const long               N       = static_cast<long>(chunks.size());
+  bool                     hasZ    = false;
+  std::vector<std::size_t> starts(N + 1, 0);
+  for(long k = 0; k < N; ++k) {
+    starts[k + 1] = starts[k] + chunks[k].points.x.size();
+    hasZ          = hasZ || !chunks[k].points.z.empty();
+  }
+
+  std::vector<double> x(starts[N]), y(starts[N]), z(hasZ ? starts[N] : 0);
+#pragma omp parallel for num_threads(threads)
+  for(long k = 0; k < N; ++k) {
+    const Columns& c = chunks[k].points;
+    std::copy(c.x.begin(), c.x.end(), x.begin() + starts[k]);
+    std::copy(c.y.begin(), c.y.end(), y.begin() + starts[k]);
+    for(std::size_t i : chunks[k].implicit) x[starts[k] + i] += offsets[k];
+    if(hasZ) {
+      auto zk = std::copy(c.z.begin(), c.z.end(), z.begin() + starts[k]);
+      std::fill(zk, z.begin() + starts[k + 1], NaN);
+    }
+  }
+  return ColumnarData(std::move(x), std::move(y), std::move(z));
+}
+
+// Memory-maps the file and parses it in parallel. Compressed files are parsed serially as they are decompressed.
+inline std::vector<DataPoint> readGnuplotDataParallel(const std::string& filename, int threads = 0)
+{
+  return detail::readFile(
+      filename, [threads](const char* begin, const char* end) { return readGnuplotDataParallel(begin, end, threads); }, detail::readDataPoints);
+}
+
+inline ColumnarData readGnuplotColumnsParallel(const std::string& filename, int threads = 0)
+{
+  return detail::readFile(
+      filename, [threads](const char* begin, const char* end) { return readGnuplotColumnsParallel(begin, end, threads); }, [](std::istream& in) { return readGnuplotColumns(in); });
+}
+
+namespace detail
+{
+inline const char* trimBlanks(const char*& begin, const char* end)
+{
+  while(begin != end && isBlank(*begin)) ++begin;
+  while(end != begin && isBlank(*(end - 1))) --end;
+  if(end - begin >= 2 && *begin == '"' && *(end - 1) == '"') {
+    ++begin;
+    --end;
+  }
+  return end;
+}
+
+// parses one delimited field, empty and non-numeric fields are NaN.
+inline double parseField(const char* begin, const char* end)
+{
+  end = trimBlanks(begin, end);
+  if(begin != end && *begin == '+') ++begin;
+  double val;
+  auto   result = std::from_chars(begin, end, val);
+  if(result.ec != std::errc() || result.ptr != end) return std::numeric_limits<double>::quiet_NaN();
+  return val;
+}
+
+/**
+ * Splits a line into fields. A `delimiter` of 0 splits on white space, otherwise
+ * fields are separated by the delimiter (and may be surrounded by white space).
+ * Calls f(begin, end) for each field.
+ */
+template<typename F>
+inline void forEachField(const char* p, const char* end, char delimiter, F&& f)
+{
+  if(delimiter == 0) {
+    while(true) {
+      while(p != end && isBlank(*p)) ++p;
+      if(p == end) return;
+      const char* q = p;
+      while(q != end && !isBlank(*q)) ++q;
+      f(p, q);
+      p = q;
+    }
+  }
+  while(true) {
+    const char* q = static_cast<const char*>(std::memchr(p, delimiter, end - p));
+    if(q == nullptr) q = end;
+    f(p, q);
+    if(q == end) return;
+    p = q + 1;
+  }
+}
+
+// ',' if the line contains a comma, otherwise 0 (white space, which includes tabs).
+inline char detectDelimiter(const char* begin, const char* end)
+{
+  return std::memchr(begin, ',', end - begin) != nullptr ? ',' : 0;
+}
+}  // namespace detail
+
+/**
+ * Reads a data file with any number of columns. The columns may be separated by
+ * white space (gnuplot style, which includes TSV), or by commas (CSV). Blank lines and
+ * lines beginning with '#' are skipped.
+ *
+ * If the first line is not numeric, it is a header that gives the column names.
+ * Otherwise the number of columns is given by the first line. Short rows are padded
+ * with NaN, and empty or non-numeric fields in CSV files are NaN.
+ */
+inline Table readTable(const char* begin, const char* end)
+{
+  const std::size_t   lines = static_cast<std::size_t>(std::count(begin, end, '\n')) + 1;
+  Table               table;
+  std::vector<double> values;
+  char                delimiter = 0;
+  bool                first     = true;
+
+  const char* line = begin;
+  while(line < end) {
+    const char* eol = static_cast<const char*>(std::memchr(line, '\n', end - line));
+    if(eol == nullptr) eol = end;
+    const char* last = eol;
+    if(last != line && *(last - 1) == '\r') --last;
+
+    const char* start = line;
+    while(start != last && detail::isBlank(*start)) ++start;
+    if(start != last && *start != '#') {
+      if(first) {
+        first     = false;
+        delimiter = detail::detectDelimiter(start, last);
+
+        // the first line is a header if its first field is not a number
+        const char* fend = start;
+        while(fend != last && (delimiter == 0 ? !detail::isBlank(*fend) : *fend != delimiter)) ++fend;
+        if(std::isnan(detail::parseField(start, fend))) {
+          std::vector<std::string> names;
+          detail::forEachField(start, last, delimiter, [&names](const char* b, const char* e) {
+            e = detail::trimBlanks(b, e);
+            names.emplace_back(b, e);
+          });
+          table = Table(std::move(names));
+          table.reserve(lines);
+          if(eol == end) break;
+          line = eol + 1;
+          continue;
+        }
+      }
+
+      values.clear();
+      if(delimiter == 0) {
+        detail::forEachNumber(start, last, [&values](double val, std::size_t) { values.push_back(val); });
+      } else {
+        detail::forEachField(start, last, delimiter, [&values](const char* b, const char* e) { values.push_back(detail::parseField(b, e)); });
+      }
+      if(table.cols() == 0) {
+        table = Table(values.size());
+        table.reserve(lines);
+      }
+      if(!values.empty()) table.push_back(values);
+    }
+
+    if(eol == end) break;
+    line = eol + 1;
   }
-  return readGnuplotData(file);
+  return table;
+}
+
+inline Table readTable(std::istream& input)
+{
+  std::string text(std::istreambuf_iterator<char>(input), {});
+  return readTable(text.data(), text.data() + text.size());
+}
+
+// Memory-maps the file and parses it in place. Compressed files are decompressed first.
+inline Table readTable(const std::string& filename)
+{
+  return detail::readFile(
+      filename, [](const char* begin, const char* end) { return readTable(begin, end); }, [](std::istream& in) { return readTable(in); });
 }
 
 // Extracts x and y values from a vector of DataPoints.
@@ -96,38 +879,619 @@ inline void extract(const std::vector<DataPoint>& data, std::vector<double>& x,
   }
 }
 
-// Extracts unique x and y values, and a 2D grid of z values from a vector of DataPoints.
-// DataPoints that are missing x, y, or z values are skipped.
-inline void extract(const std::vector<DataPoint>& data, std::vector<double>& x, std::vector<double>& y, std::vector<std::vector<double>>& z)
+// Extracts x and y values from columnar data.
+// Points that are missing x or y values are skipped. If no values are missing, the
+// columns can be used directly instead.
+inline void extract(const ColumnarData& data, std::vector<double>& x, std::vector<double>& y)
 {
+  if(data.hasAllXY()) {
+    x = data.x();
+    y = data.y();
+    return;
+  }
+
   x.clear();
   y.clear();
-  z.clear();
+  for(std::size_t i = 0; i < data.size(); ++i) {
+    if(data.hasX(i) && data.hasY(i)) {
+      x.push_back(data.x()[i]);
+      y.push_back(data.y()[i]);
+    }
+  }
+}
 
-  std::set<double> unique_x, unique_y;
-  for(const auto& p : data) {
-    if(p.x.has_value() && p.y.has_value() && p.z.has_value()) {
-      unique_x.insert(p.x.value());
-      unique_y.insert(p.y.value());
+// Describes how extract() reconstructed a 2D grid from a list of points.
+enum class GridReconstruction {
+  XBlocks,  // blocks of constant x with y varying fastest (gnuplot's scan blocks), one linear pass
+  YBlocks,  // blocks of constant y with x varying fastest, one linear pass
+  Sorted    // scattered points, grid coordinates were found by sorting
+};
+
+namespace detail
+{
+// Resizes a grid of z values (nested vectors or a _2D::Grid) to rows x cols.
+inline void assignGrid(std::vector<std::vector<double>>& z, std::size_t rows, std::size_t cols)
+{
+  z.assign(rows, std::vector<double>(cols));
+}
+
+inline void assignGrid(_2D::Grid<double>& z, std::size_t rows, std::size_t cols)
+{
+  z.assign(rows, cols);
+}
+
+/**
+ * Tries to build the grid in a single pass, assuming the points are ordered in blocks
+ * that have a constant "outer" coordinate and the same, strictly monotonic sequence of
+ * "inner" coordinates. This is how gnuplot scans are written (each blank line separated
+ * block is one value of the outer coordinate).
+ *
+ * `get(k, outer, inner, z)` returns the k'th complete point. If the points do not have
+ * this structure, false is returned and the outputs are unspecified.
+ */
+template<typename Get, typename Z>
+bool extractBlockedGrid(std::size_t M, Get&& get, std::vector<double>& outer, std::vector<double>& inner, Z& z, bool transpose)
+{
+  if(M == 0) return false;
+
+  double o, in, v;
+  get(0, o, in, v);
+  const double o0 = o;
+
+  // the first block determines the inner coordinates
+  inner.clear();
+  inner.push_back(in);
+  for(std::size_t k = 1; k < M; ++k) {
+    get(k, o, in, v);
+    if(o != o0) break;
+    inner.push_back(in);
+  }
+  const std::size_t nin = inner.size();
+  if(M % nin != 0) return false;
+  const std::size_t nout = M / nin;
+
+  const bool innerDecreasing = nin > 1 && inner[1] < inner[0];
+  for(std::size_t j = 1; j < nin; ++j) {
+    if(innerDecreasing ? !(inner[j] < inner[j - 1]) : !(inner[j] > inner[j - 1])) return false;
+  }
+
+  // the first point of the second block gives the direction of the outer coordinate
+  bool outerDecreasing = false;
+  if(nout > 1) {
+    get(nin, o, in, v);
+    outerDecreasing = o < o0;
+  }
+
+  outer.resize(nout);
+  if(transpose) {
+    assignGrid(z, nin, nout);
+  } else {
+    assignGrid(z, nout, nin);
+  }
+
+  for(std::size_t b = 0, k = 0; b < nout; ++b) {
+    for(std::size_t j = 0; j < nin; ++j, ++k) {
+      get(k, o, in, v);
+      if(in != inner[j]) return false;
+      if(j == 0) {
+        outer[b] = o;
+        if(b > 0 && (outerDecreasing ? !(o < outer[b - 1]) : !(o > outer[b - 1]))) return false;
+      } else if(o != outer[b]) {
+        return false;
+      }
+
+      // decreasing coordinates are stored in reverse so that the grid is increasing
+      std::size_t bi = outerDecreasing ? nout - 1 - b : b;
+      std::size_t ji = innerDecreasing ? nin - 1 - j : j;
+      if(transpose) {
+        z[ji][bi] = v;
+      } else {
+        z[bi][ji] = v;
+      }
     }
   }
+  if(outerDecreasing) std::reverse(outer.begin(), outer.end());
+  if(innerDecreasing) std::reverse(inner.begin(), inner.end());
 
-  x.assign(unique_x.begin(), unique_x.end());
-  y.assign(unique_y.begin(), unique_y.end());
+  return true;
+}
 
-  std::map<double, size_t> x_map, y_map;
-  for(size_t i = 0; i < x.size(); ++i) x_map[x[i]] = i;
-  for(size_t i = 0; i < y.size(); ++i) y_map[y[i]] = i;
+/**
+ * Builds the grid from scattered points by sorting the coordinates and
+ * looking up the index of each point with a binary search.
+ */
+template<typename Get, typename Z>
+void extractSortedGrid(std::size_t M, Get&& get, std::vector<double>& x, std::vector<double>& y, Z& z)
+{
+  double px, py, pz;
+  x.resize(M);
+  y.resize(M);
+  for(std::size_t k = 0; k < M; ++k) get(k, x[k], y[k], pz);
+  std::sort(x.begin(), x.end());
+  x.erase(std::unique(x.begin(), x.end()), x.end());
+  std::sort(y.begin(), y.end());
+  y.erase(std::unique(y.begin(), y.end()), y.end());
 
-  z.resize(x.size(), std::vector<double>(y.size()));
+  assignGrid(z, x.size(), y.size());
+  for(std::size_t k = 0; k < M; ++k) {
+    get(k, px, py, pz);
+    std::size_t i = std::lower_bound(x.begin(), x.end(), px) - x.begin();
+    std::size_t j = std::lower_bound(y.begin(), y.end(), py) - y.begin();
+    z[i][j]       = pz;
+  }
+}
 
-  for(const auto& p : data) {
-    if(p.x.has_value() && p.y.has_value() && p.z.has_value()) {
-      z[x_map[p.x.value()]][y_map[p.y.value()]] = p.z.value();
+template<typename Data, typename Z>
+GridReconstruction extractGrid(const Data& data, std::vector<double>& x, std::vector<double>& y, Z& z)
+{
+  // index the complete points, only if some points are incomplete
+  std::vector<std::size_t> complete;
+  std::size_t              M = 0;
+  for(std::size_t i = 0; i < data.size(); ++i) {
+    if(data.hasX(i) && data.hasY(i) && data.hasZ(i)) ++M;
+  }
+  if(M != data.size()) {
+    complete.reserve(M);
+    for(std::size_t i = 0; i < data.size(); ++i) {
+      if(data.hasX(i) && data.hasY(i) && data.hasZ(i)) complete.push_back(i);
     }
   }
+  auto index = [&complete](std::size_t k) { return complete.empty() ? k : complete[k]; };
+
+  auto getXY = [&](std::size_t k, double& px, double& py, double& pz) {
+    std::size_t i = index(k);
+    px            = data.xValue(i);
+    py            = data.yValue(i);
+    pz            = data.zValue(i);
+  };
+  auto getYX = [&](std::size_t k, double& py, double& px, double& pz) { getXY(k, px, py, pz); };
+
+  if(extractBlockedGrid(M, getXY, x, y, z, false)) return GridReconstruction::XBlocks;
+  if(extractBlockedGrid(M, getYX, y, x, z, true)) return GridReconstruction::YBlocks;
+  extractSortedGrid(M, getXY, x, y, z);
+  return GridReconstruction::Sorted;
+}
+
+// gives a vector of DataPoints the same interface as ColumnarData for extractGrid
+struct DataPointsView {
+  const std::vector<DataPoint>& data;
+  std::size_t                   size() const { return data.size(); }
+  bool                          hasX(std::size_t i) const { return data[i].x.has_value(); }
+  bool                          hasY(std::size_t i) const { return data[i].y.has_value(); }
+  bool                          hasZ(std::size_t i) const { return data[i].z.has_value(); }
+  double                        xValue(std::size_t i) const { return *data[i].x; }
+  double                        yValue(std::size_t i) const { return *data[i].y; }
+  double                        zValue(std::size_t i) const { return *data[i].z; }
+};
+
+struct ColumnarDataView {
+  const ColumnarData& data;
+  std::size_t         size() const { return data.size(); }
+  bool                hasX(std::size_t i) const { return data.hasX(i); }
+  bool                hasY(std::size_t i) const { return data.hasY(i); }
+  bool                hasZ(std::size_t i) const { return data.hasZ(i); }
+  double              xValue(std::size_t i) const { return data.x()[i]; }
+  double              yValue(std::size_t i) const { return data.y()[i]; }
+  double              zValue(std::size_t i) const { return data.z()[i]; }
+};
+}  // namespace detail
+
+// Extracts unique x and y values, and a 2D grid of z values from a vector of DataPoints.
+// DataPoints that are missing x, y, or z values are skipped.
+//
+// If the points are ordered in blocks (like gnuplot scans), the grid is built in a single
+// pass. Otherwise the coordinates are sorted. The method that was used is returned.
+inline GridReconstruction extract(const std::vector<DataPoint>& data, std::vector<double>& x, std::vector<double>& y, std::vector<std::vector<double>>& z)
+{
+  return detail::extractGrid(detail::DataPointsView{data}, x, y, z);
+}
+
+// Extracts unique x and y values, and a 2D grid of z values from columnar data.
+// Points that are missing x, y, or z values are skipped.
+inline GridReconstruction extract(const ColumnarData& data, std::vector<double>& x, std::vector<double>& y, std::vector<std::vector<double>>& z)
+{
+  return detail::extractGrid(detail::ColumnarDataView{data}, x, y, z);
+}
+
+// Extracts the z values into a contiguous grid instead of a nested vector.
+inline GridReconstruction extract(const std::vector<DataPoint>& data, std::vector<double>& x, std::vector<double>& y, _2D::Grid<double>& z)
+{
+  return detail::extractGrid(detail::DataPointsView{data}, x, y, z);
+}
+
+inline GridReconstruction extract(const ColumnarData& data, std::vector<double>& x, std::vector<double>& y, _2D::Grid<double>& z)
+{
+  return detail::extractGrid(detail::ColumnarDataView{data}, x, y, z);
 }
 
 }  // namespace gnuplot
 
+namespace binary
+{
+/**
+ * A view of every stride'th double in a block of memory.
+ *
+ * Provides operator[] and size(), so a view can be passed to the integrators
+ * just like a container. The view does not own the memory it refers to.
+ */
+class ColumnView
+{
+ public:
+  ColumnView() = default;
+  ColumnView(const double* data, std::size_t size, std::ptrdiff_t stride = 1) : m_data(data), m_size(size), m_stride(stride) {}
+
+  double         operator[](std::size_t i) const { return m_data[static_cast<std::ptrdiff_t>(i) * m_stride]; }
+  std::size_t    size() const { return m_size; }
+  const double*  data() const { return m_data; }
+  std::ptrdiff_t stride() const { return m_stride; }
+
+ private:
+  const double*  m_data   = nullptr;
+  std::size_t    m_size   = 0;
+  std::ptrdiff_t m_stride = 1;
+};
+
+/**
+ * A 2D view of a block of doubles with arbitrary row and column strides.
+ *
+ * Provides operator()(i,j), rows() and cols(), so a view can be passed to the
+ * 2D integrators. The view does not own the memory it refers to.
+ */
+class GridView
+{
+ public:
+  GridView() = default;
+  GridView(const double* data, std::size_t rows, std::size_t cols, std::ptrdiff_t rowStride, std::ptrdiff_t colStride)
+      : m_data(data), m_rows(rows), m_cols(cols), m_rowStride(rowStride), m_colStride(colStride)
+  {
+  }
+
+  double operator()(std::size_t i, std::size_t j) const
+  {
+    return m_data[static_cast<std::ptrdiff_t>(i) * m_rowStride + static_cast<std::ptrdiff_t>(j) * m_colStride];
+  }
+  std::size_t rows() const { return m_rows; }
+  std::size_t cols() const { return m_cols; }
+  ColumnView  row(std::size_t i) const { return {m_data + static_cast<std::ptrdiff_t>(i) * m_rowStride, m_cols, m_colStride}; }
+  ColumnView  col(std::size_t j) const { return {m_data + static_cast<std::ptrdiff_t>(j) * m_colStride, m_rows, m_rowStride}; }
+
+ private:
+  const double*  m_data      = nullptr;
+  std::size_t    m_rows      = 0;
+  std::size_t    m_cols      = 0;
+  std::ptrdiff_t m_rowStride = 0;
+  std::ptrdiff_t m_colStride = 0;
+};
+
+enum class Format {
+  Text,  // anything that is not one of the binary formats, i.e. gnuplot text
+  Npy,   // NumPy .npy file, float64 ('<f8') data with 1 or 2 dimensions
+  Raw    // the "LIBINTF8" magic, uint64 rows, uint64 cols, then row-major little-endian float64 data
+};
+
+namespace detail
+{
+inline const char npyMagic[] = "\x93NUMPY";
+inline const char rawMagic[] = "LIBINTF8";
+
+inline void requireLittleEndian()
+{
+  const std::uint16_t one = 1;
+  unsigned char       first;
+  std::memcpy(&first, &one, 1);
+  if(first != 1) {
+    throw std::runtime_error("Binary float64 I/O requires a little-endian host.");
+  }
+}
+
+template<typename U>
+U readLittleEndian(const char* p)
+{
+  U value = 0;
+  for(std::size_t i = 0; i < sizeof(U); ++i) {
+    value |= static_cast<U>(static_cast<unsigned char>(p[i])) << (8 * i);
+  }
+  return value;
+}
+
+template<typename U>
+void writeLittleEndian(std::ostream& out, U value)
+{
+  char bytes[sizeof(U)];
+  for(std::size_t i = 0; i < sizeof(U); ++i) {
+    bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+  out.write(bytes, sizeof(U));
+}
+
+// Returns the value of 'key' in a npy header dictionary: the contents of a quoted string, a
+// tuple or list including its brackets, or the text up to the next ',' or '}' (e.g. True).
+inline std::string npyHeaderValue(const std::string& header, const std::string& key)
+{
+  std::size_t pos = header.find("'" + key + "'");
+  if(pos == std::string::npos) pos = header.find("\"" + key + "\"");
+  if(pos == std::string::npos) return "";
+  pos = header.find(':', pos);
+  if(pos == std::string::npos) return "";
+  pos = header.find_first_not_of(" ", pos + 1);
+  if(pos == std::string::npos) return "";
+
+  char c = header[pos];
+  if(c == '\'' || c == '"') {
+    std::size_t end = header.find(c, pos + 1);
+    return end == std::string::npos ? "" : header.substr(pos + 1, end - pos - 1);
+  }
+  if(c == '(' || c == '[') {
+    // lists of fields (structured dtypes) contain nested tuples
+    int depth = 0;
+    for(std::size_t end = pos; end < header.size(); ++end) {
+      if(header[end] == '(' || header[end] == '[') ++depth;
+      if((header[end] == ')' || header[end] == ']') && --depth == 0) return header.substr(pos, end - pos + 1);
+    }
+    return "";
+  }
+  std::size_t end = header.find_first_of(",}", pos);
+  if(end == std::string::npos) return "";
+  end = header.find_last_not_of(" ", end - 1);
+  return header.substr(pos, end - pos + 1);
+}
+}  // namespace detail
+
+/**
+ * A 2D array of doubles read from a binary file.
+ *
+ * The file is memory-mapped and the array refers directly to the mapped
+ * data, nothing is copied. Views returned by column(), row() and grid() are
+ * only valid while the Array is alive. 1D arrays are treated as a single column.
+ */
+class Array
+{
+ public:
+  Array() = default;
+  Array(MappedFile&& file, std::size_t offset, std::size_t rows, std::size_t cols, bool fortranOrder)
+      : m_file(std::move(file)), m_offset(offset), m_rows(rows), m_cols(cols), m_fortranOrder(fortranOrder)
+  {
+    if(m_offset % alignof(double) != 0) {
+      throw std::runtime_error("Binary data is not aligned to a multiple of 8 bytes.");
+    }
+    // the shape comes from the file, so the number of elements and bytes may not fit in a size_t
+    if(m_rows != 0 && m_cols > std::numeric_limits<std::size_t>::max() / m_rows) {
+      throw std::runtime_error("Binary file header has too many elements.");
+    }
+    if(m_rows * m_cols > std::numeric_limits<std::size_t>::max() / sizeof(double)) {
+      throw std::runtime_error("Binary file header has too many elements.");
+    }
+    if(m_file.size() < m_offset || (m_file.size() - m_offset) / sizeof(double) < m_rows * m_cols) {
+      throw std::runtime_error("Binary file is smaller than its header says.");
+    }
+  }
+
+  std::size_t   rows() const { return m_rows; }
+  std::size_t   cols() const { return m_cols; }
+  bool          fortranOrder() const { return m_fortranOrder; }
+  const double* data() const { return reinterpret_cast<const double*>(m_file.data() + m_offset); }
+
+  std::ptrdiff_t rowStride() const { return m_fortranOrder ? 1 : static_cast<std::ptrdiff_t>(m_cols); }
+  std::ptrdiff_t colStride() const { return m_fortranOrder ? static_cast<std::ptrdiff_t>(m_rows) : 1; }
+
+  double     operator()(std::size_t i, std::size_t j) const { return grid()(i, j); }
+  GridView   grid() const { return {data(), m_rows, m_cols, rowStride(), colStride()}; }
+  ColumnView column(std::size_t j) const { return grid().col(j); }
+  ColumnView row(std::size_t i) const { return grid().row(i); }
+
+ private:
+  MappedFile  m_file;
+  std::size_t m_offset       = 0;
+  std::size_t m_rows         = 0;
+  std::size_t m_cols         = 0;
+  bool        m_fortranOrder = false;
+};
+
+// Views of the x and y coordinates and z values of a 2D function.
+struct MatrixViews {
+  ColumnView x;
+  ColumnView y;
+  GridView   z;
+};
+
+/**
+ * Interprets an array in gnuplot's "nonuniform matrix" layout: the first row holds
+ * the y coordinates, the first column holds the x coordinates, and the remaining
+ * elements hold z(x_i,y_j). The first element is ignored (gnuplot stores the number
+ * of y coordinates there).
+ */
+inline MatrixViews nonuniformMatrix(const Array& a)
+{
+  if(a.rows() < 2 || a.cols() < 2) {
+    throw std::runtime_error("A nonuniform matrix must have at least two rows and two columns.");
+  }
+  const double* data = a.data();
+  GridView     z(data + a.rowStride() + a.colStride(), a.rows() - 1, a.cols() - 1, a.rowStride(), a.colStride());
+  ColumnView   x(data + a.rowStride(), a.rows() - 1, a.rowStride());
+  ColumnView   y(data + a.colStride(), a.cols() - 1, a.colStride());
+  return {x, y, z};
+}
+
+// Detects the format of a file from its first few bytes.
+inline Format detectFormat(const std::string& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if(!file) {
+    throw std::runtime_error("Failed to open file: " + filename);
+  }
+  char magic[8] = {};
+  file.read(magic, sizeof(magic));
+  std::size_t n = static_cast<std::size_t>(file.gcount());
+  if(n >= 6 && std::memcmp(magic, detail::npyMagic, 6) == 0) return Format::Npy;
+  if(n >= 8 && std::memcmp(magic, detail::rawMagic, 8) == 0) return Format::Raw;
+  return Format::Text;
+}
+
+// Memory-maps a NumPy .npy file. Only little-endian float64 arrays with one or two dimensions are supported.
+inline Array readNpy(const std::string& filename)
+{
+  detail::requireLittleEndian();
+  MappedFile file(filename);
+  if(file.size() < 10 || std::memcmp(file.data(), detail::npyMagic, 6) != 0) {
+    throw std::runtime_error("Not a .npy file: " + filename);
+  }
+
+  std::size_t major = static_cast<unsigned char>(file.data()[6]);
+  std::size_t offset, headerLength;
+  if(major == 1) {
+    headerLength = detail::readLittleEndian<std::uint16_t>(file.data() + 8);
+    offset       = 10;
+  } else if(major == 2 || major == 3) {
+    if(file.size() < 12) throw std::runtime_error("Truncated .npy header: " + filename);
+    headerLength = detail::readLittleEndian<std::uint32_t>(file.data() + 8);
+    offset       = 12;
+  } else {
+    throw std::runtime_error("Unsupported .npy version in " + filename);
+  }
+  if(file.size() < offset + headerLength) throw std::runtime_error("Truncated .npy header: " + filename);
+  std::string header(file.data() + offset, headerLength);
+  offset += headerLength;
+
+  std::string descr = detail::npyHeaderValue(header, "descr");
+  if(descr != "<f8" && descr != "=f8") {
+    throw std::runtime_error("Only little-endian float64 ('<f8') .npy files are supported: " + filename);
+  }
+  bool fortranOrder = detail::npyHeaderValue(header, "fortran_order") == "True";
+
+  std::string shapeText = detail::npyHeaderValue(header, "shape");
+  if(shapeText.empty() || shapeText[0] != '(') {
+    throw std::runtime_error("Could not parse .npy shape in " + filename);
+  }
+  std::vector<std::size_t> shape;
+  const char*              p   = shapeText.data() + 1;
+  const char*              end = shapeText.data() + shapeText.find(')');
+  while(p < end) {
+    while(p < end && (*p == ' ' || *p == ',')) ++p;
+    if(p == end) break;
+    std::size_t dim;
+    auto        result = std::from_chars(p, end, dim);
+    if(result.ec != std::errc()) throw std::runtime_error("Could not parse .npy shape in " + filename);
+    shape.push_back(dim);
+    p = result.ptr;
+  }
+  if(shape.empty() || shape.size() > 2) {
+    throw std::runtime_error("Only 1D and 2D .npy arrays are supported: " + filename);
+  }
+
+  return Array(std::move(file), offset, shape[0], shape.size() == 2 ? shape[1] : 1, fortranOrder);
+}
+
+// Memory-maps a raw float64 file (see Format::Raw).
+inline Array readRaw(const std::string& filename)
+{
+  detail::requireLittleEndian();
+  MappedFile file(filename);
+  if(file.size() < 24 || std::memcmp(file.data(), detail::rawMagic, 8) != 0) {
+    throw std::runtime_error("Not a raw float64 file: " + filename);
+  }
+  std::size_t rows = detail::readLittleEndian<std::uint64_t>(file.data() + 8);
+  std::size_t cols = detail::readLittleEndian<std::uint64_t>(file.data() + 16);
+  return Array(std::move(file), 24, rows, cols, false);
+}
+
+// Reads a binary file, detecting the format from its contents.
+inline Array read(const std::string& filename)
+{
+  switch(detectFormat(filename)) {
+    case Format::Npy:
+      return readNpy(filename);
+    case Format::Raw:
+      return readRaw(filename);
+    default:
+      throw std::runtime_error("Not a binary data file: " + filename);
+  }
+}
+
+// Writes a row-major block of doubles as a version 1.0 .npy file.
+inline void writeNpy(std::ostream& out, const double* data, std::size_t rows, std::size_t cols)
+{
+  detail::requireLittleEndian();
+  std::string header = "{'descr': '<f8', 'fortran_order': False, 'shape': (" + std::to_string(rows) + ", " + std::to_string(cols) + "), }";
+  // the data has to start on a 64 byte boundary, and the header ends with a newline
+  std::size_t total = 10 + header.size() + 1;
+  header.append((64 - total % 64) % 64, ' ');
+  header += '\n';
+
+  out.write(detail::npyMagic, 6);
+  out.put(1);
+  out.put(0);
+  detail::writeLittleEndian(out, static_cast<std::uint16_t>(header.size()));
+  out.write(header.data(), header.size());
+  out.write(reinterpret_cast<const char*>(data), rows * cols * sizeof(double));
+}
+
+// Writes a row-major block of doubles as a raw float64 file (see Format::Raw).
+inline void writeRaw(std::ostream& out, const double* data, std::size_t rows, std::size_t cols)
+{
+  detail::requireLittleEndian();
+  out.write(detail::rawMagic, 8);
+  detail::writeLittleEndian(out, static_cast<std::uint64_t>(rows));
+  detail::writeLittleEndian(out, static_cast<std::uint64_t>(cols));
+  out.write(reinterpret_cast<const char*>(data), rows * cols * sizeof(double));
+}
+
+// Writes a row-major block of doubles to a file in the given binary format.
+inline void write(const std::string& filename, Format format, const double* data, std::size_t rows, std::size_t cols)
+{
+  std::ofstream out(filename, std::ios::binary);
+  if(!out) {
+    throw std::runtime_error("Failed to open file: " + filename);
+  }
+  if(format == Format::Npy) {
+    writeNpy(out, data, rows, cols);
+  } else if(format == Format::Raw) {
+    writeRaw(out, data, rows, cols);
+  } else {
+    throw std::runtime_error("Can only write binary formats.");
+  }
+  if(!out) {
+    throw std::runtime_error("Failed to write file: " + filename);
+  }
+}
+
+/**
+ * Writes 1D containers as the columns of a file, e.g. x and y values. All
+ * containers must have the same size.
+ */
+template<typename... Columns>
+void writeColumns(const std::string& filename, Format format, const Columns&... columns)
+{
+  const std::size_t   cols = sizeof...(Columns);
+  const std::size_t   rows = std::min({static_cast<std::size_t>(columns.size())...});
+  std::vector<double> data(rows * cols);
+  std::size_t         j    = 0;
+  auto                fill = [&](const auto& c) {
+    for(std::size_t i = 0; i < rows; ++i) data[i * cols + j] = c[i];
+    ++j;
+  };
+  (fill(columns), ...);
+  write(filename, format, data.data(), rows, cols);
+}
+
+/**
+ * Writes a 2D function z(x_i,y_j) in the nonuniform matrix layout (see
+ * nonuniformMatrix()). z must support z[i][j].
+ */
+template<typename X, typename Y, typename Z>
+void writeGrid(const std::string& filename, Format format, const X& x, const Y& y, const Z& z)
+{
+  const std::size_t   rows = x.size() + 1;
+  const std::size_t   cols = y.size() + 1;
+  std::vector<double> data(rows * cols);
+  data[0] = static_cast<double>(y.size());
+  for(std::size_t j = 0; j < y.size(); ++j) data[j + 1] = y[j];
+  for(std::size_t i = 0; i < x.size(); ++i) {
+    data[(i + 1) * cols] = x[i];
+    for(std::size_t j = 0; j < y.size(); ++j) data[(i + 1) * cols + j + 1] = z[i][j];
+  }
+  write(filename, format, data.data(), rows, cols);
+}
+
+}  // namespace binary
+
 }  // namespace libIntegrate
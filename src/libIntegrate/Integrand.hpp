@@ -0,0 +1,205 @@
+#pragma once
+
+/** @file Integrand.hpp
+ * @brief Support for vector-valued integrands in the callable rules
+ *
+ * The callable rules accept functions that return a vector of T (std::array,
+ * Eigen vectors, or any type with size() and operator[] or operator()) as
+ * well as scalars. Every component is summed with its own accumulator, so all
+ * of the components are computed from a single evaluation at each node.
+ */
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./Summation.hpp"
+#include "./_1D/Utils.hpp"
+
+namespace libIntegrate
+{
+namespace detail
+{
+/**
+ * True if V is a vector of T rather than a scalar: it is not convertible to
+ * T, has a size() method, and its elements are convertible to T.
+ */
+template<typename T, typename V, typename SFINAE = void>
+struct isVectorValue : std::false_type {
+};
+template<typename T, typename V>
+struct isVectorValue<T, V, std::void_t<decltype(std::declval<const V &>().size()), decltype(libIntegrate::getElement(std::declval<const V &>(), 0))>>
+    : std::bool_constant<!std::is_convertible_v<V, T> && std::is_convertible_v<decltype(libIntegrate::getElement(std::declval<const V &>(), 0)), T>> {
+};
+
+template<typename T, typename V>
+inline constexpr bool isVectorValue_v = isVectorValue<T, std::decay_t<V>>::value;
+
+/**
+ * The type of the integral of F(Args...) with data type T: T for scalar
+ * integrands, and the integrand's own vector type for vector-valued ones.
+ */
+template<typename T, typename F, typename... Args>
+using IntegralOf = std::conditional_t<isVectorValue_v<T, std::invoke_result_t<F, Args...>>, std::decay_t<std::invoke_result_t<F, Args...>>, T>;
+
+/**
+ * The callable rules with a number of intervals NN set at compile time unroll
+ * their loops (for scalar integrands) if NN is at most this, so that small
+ * integrals can be inlined completely, and evaluated at compile time if the
+ * integrand is constexpr.
+ */
+inline constexpr std::size_t unrollLimit = 64;
+
+/**
+ * The number of components of V if it is known at compile time
+ * (std::array and fixed-size Eigen vectors), and 0 otherwise.
+ */
+template<typename V, typename SFINAE = void>
+struct staticSize : std::integral_constant<std::size_t, 0> {
+};
+template<typename V>
+struct staticSize<V, std::enable_if_t<(V::SizeAtCompileTime > 0)>> : std::integral_constant<std::size_t, V::SizeAtCompileTime> {
+};
+template<typename T, std::size_t N>
+struct staticSize<std::array<T, N>> : std::integral_constant<std::size_t, N> {
+};
+
+// writable access to component i of a vector value.
+template<typename V>
+auto component(V &v, std::size_t i, priority<1>) -> decltype(v(i))
+{
+  return v(i);
+}
+template<typename V>
+auto component(V &v, std::size_t i, priority<2>) -> decltype(v[i])
+{
+  return v[i];
+}
+template<typename V>
+decltype(auto) component(V &v, std::size_t i)
+{
+  return component(v, i, priority<10>{});
+}
+
+/**
+ * y += a*x, for scalars and for each component of vector values.
+ */
+template<typename T, typename X, typename Y>
+void axpy(T a, const X &x, Y &y)
+{
+  if constexpr(isVectorValue_v<T, Y>) {
+    for(std::size_t i = 0; i < static_cast<std::size_t>(y.size()); i++) component(y, i) += a * libIntegrate::getElement(x, i);
+  } else {
+    y += a * x;
+  }
+}
+
+/**
+ * Return a*y, for scalars and for each component of vector values.
+ */
+template<typename T, typename Y>
+Y scaled(Y y, T a)
+{
+  if constexpr(isVectorValue_v<T, Y>) {
+    for(std::size_t i = 0; i < static_cast<std::size_t>(y.size()); i++) component(y, i) *= a;
+    return y;
+  } else {
+    return y * a;
+  }
+}
+
+/**
+ * Accumulates the values of an integrand with result type R (see
+ * IntegralOf) with the accumulator of summation policy S. Vector values are
+ * accumulated component by component, with storage on the stack if the
+ * number of components is known at compile time.
+ */
+template<typename S, typename T, typename R, typename SFINAE = void>
+class IntegrandAccumulator
+{
+ public:
+  void add(const R &v) { m_sum.add(v); }
+  void add(T w, const R &v) { m_sum.add(w * v); }
+  R    value() const { return m_sum.value(); }
+
+ private:
+  summation::Accumulator<S, T> m_sum;
+};
+
+template<typename S, typename T, typename R>
+class IntegrandAccumulator<S, T, R, std::enable_if_t<isVectorValue_v<T, R>>>
+{
+  using Sums = std::conditional_t<(staticSize<R>::value > 0), std::array<summation::Accumulator<S, T>, staticSize<R>::value>,
+                                  std::vector<summation::Accumulator<S, T>>>;
+
+ public:
+  void add(const R &v) { add(T(1), v); }
+  void add(T w, const R &v)
+  {
+    if(m_empty) {
+      // the first value gives the number of components (and anything else a vector type needs to be constructed).
+      m_value = v;
+      m_empty = false;
+      if constexpr(staticSize<R>::value == 0) m_sums.resize(v.size());
+    }
+    for(std::size_t i = 0; i < m_sums.size(); i++) m_sums[i].add(w * libIntegrate::getElement(v, i));
+  }
+  R value() const
+  {
+    R r = m_value;
+    for(std::size_t i = 0; i < m_sums.size(); i++) component(r, i) = m_sums[i].value();
+    return r;
+  }
+
+ private:
+  Sums m_sums{};
+  R    m_value{};
+  bool m_empty = true;
+};
+
+/**
+ * Integrate each component of a vector-valued integrand that has already been
+ * evaluated at every node. For each component c, integrate(y) is given a
+ * callable y(k) that returns component c of values[k], and integrates it with
+ * a rule for scalar data.
+ */
+template<typename R, typename I>
+R integrateComponents(const std::vector<R> &values, I integrate)
+{
+  R r = values.front();
+  for(std::size_t c = 0; c < static_cast<std::size_t>(r.size()); c++)
+    component(r, c) = integrate([&values, c](std::size_t i) { return libIntegrate::getElement(values[i], c); });
+  return r;
+}
+
+}  // namespace detail
+
+/**
+ * Wraps an integrand and counts the number of times it is evaluated. The
+ * rules copy the integrand, so the count is kept in a variable owned by the
+ * caller:
+ *
+ *   std::size_t calls = 0;
+ *   double I = integrate(libIntegrate::EvaluationCounter(f, calls), a, b, N);
+ */
+template<typename F>
+class EvaluationCounter
+{
+ public:
+  constexpr EvaluationCounter(F f, std::size_t &count) : m_f(std::move(f)), m_count(&count) {}
+
+  template<typename... Args>
+  constexpr auto operator()(Args &&...args) const -> decltype(std::declval<const F &>()(std::forward<Args>(args)...))
+  {
+    ++*m_count;
+    return m_f(std::forward<Args>(args)...);
+  }
+
+ private:
+  F            m_f;
+  std::size_t *m_count;
+};
+
+}  // namespace libIntegrate
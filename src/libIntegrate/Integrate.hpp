@@ -10,11 +10,18 @@
 #include "./_1D/RiemannRule.hpp"
 #include "./_1D/TrapezoidRule.hpp"
 #include "./_1D/SimpsonRule.hpp"
+#include "./_1D/CubicSplineRule.hpp"
+#include "./_1D/GregoryRule.hpp"
+#include "./_1D/RombergRule.hpp"
+#include "./_1D/QuadraturePlan.hpp"
 #include "./_1D/GaussianQuadratures/GaussLegendre.hpp"
 #include "./_1D/RandomAccessLambda.hpp"
 
+#include "./_2D/Grid.hpp"
 #include "./_2D/RiemannRule.hpp"
 #include "./_2D/SimpsonRule.hpp"
 #include "./_2D/TrapezoidRule.hpp"
+#include "./_2D/CubicSplineRule.hpp"
+#include "./_2D/GregoryRule.hpp"
 #include "./_2D/GaussianQuadratures/GaussLegendre.hpp"
 #include "./_2D/RandomAccessLambda.hpp"
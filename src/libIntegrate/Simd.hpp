@@ -0,0 +1,457 @@
+#pragma once
+
+/** @file Simd.hpp
+ * @brief Vectorized kernels used by the 1D rules for data stored in contiguous float and double arrays
+ *
+ * With GCC and Clang the kernels are written with vector extensions and use
+ * several independent vector accumulators, so the sums are not limited by
+ * the latency of a single floating point add. On x86-64 the widest instruction
+ * set supported by the CPU (SSE2, AVX2, or AVX-512) is selected at runtime. Other
+ * compilers use a portable version with eight scalar accumulators.
+ *
+ * The kernels take a summation policy (see Summation.hpp), each lane keeps
+ * its own running sums of the policy.
+ *
+ * Define LIBINTEGRATE_NO_SIMD to always use the portable version.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "./Summation.hpp"
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#if !defined(LIBINTEGRATE_NO_SIMD) && defined(__GNUC__)
+#define LIBINTEGRATE_VECTOR_EXTENSIONS
+#if defined(__x86_64__)
+#define LIBINTEGRATE_SIMD_DISPATCH
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define LIBINTEGRATE_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define LIBINTEGRATE_ALWAYS_INLINE inline
+#endif
+
+namespace libIntegrate
+{
+namespace detail
+{
+template<typename C, typename = void>
+struct hasContiguousIterator : std::false_type {
+};
+#if defined(__cpp_lib_concepts)
+template<typename C>
+struct hasContiguousIterator<C, std::enable_if_t<std::contiguous_iterator<decltype(std::begin(std::declval<const C&>()))>>> : std::true_type {
+};
+#endif
+}  // namespace detail
+
+/**
+ * A trait that tells the rules that the elements of a container are stored
+ * contiguously, so std::data(c)[i] is the same element as getElement(c,i).
+ *
+ * std::vector and std::array are always detected. With C++20, any container
+ * with a contiguous iterator (std::span, ...) is detected too. Specialize
+ * this trait to enable the vectorized kernels for other containers.
+ */
+template<typename C>
+struct is_contiguous : detail::hasContiguousIterator<C> {
+};
+template<typename T, typename A>
+struct is_contiguous<std::vector<T, A>> : std::true_type {
+};
+template<typename T, std::size_t N>
+struct is_contiguous<std::array<T, N>> : std::true_type {
+};
+
+namespace detail
+{
+/**
+ * True if C is a contiguous container of T, and T is float or double.
+ */
+template<typename T, typename C, typename = void>
+struct isContiguousOf : std::false_type {
+};
+template<typename T, typename C>
+struct isContiguousOf<T, C, std::enable_if_t<std::is_same_v<decltype(std::data(std::declval<const C&>())), const T*>>>
+    : std::bool_constant<is_contiguous<C>::value && (std::is_same_v<T, float> || std::is_same_v<T, double>)> {
+};
+template<typename T, typename C>
+inline constexpr bool isContiguousOf_v = isContiguousOf<T, C>::value;
+
+enum class SimdLevel { portable, sse2, avx2, avx512 };
+
+/**
+ * The widest instruction set supported by the CPU, detected on the first call.
+ */
+inline SimdLevel simdLevel()
+{
+#if defined(LIBINTEGRATE_SIMD_DISPATCH)
+  static const SimdLevel level = []() {
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) return SimdLevel::avx512;
+    if(__builtin_cpu_supports("avx2")) return SimdLevel::avx2;
+    return SimdLevel::sse2;
+  }();
+  return level;
+#elif defined(LIBINTEGRATE_VECTOR_EXTENSIONS)
+  return SimdLevel::sse2;
+#else
+  return SimdLevel::portable;
+#endif
+}
+
+inline const char* simdLevelName(SimdLevel level)
+{
+  switch(level) {
+    case SimdLevel::sse2:
+      return "sse2";
+    case SimdLevel::avx2:
+      return "avx2";
+    case SimdLevel::avx512:
+      return "avx512";
+    default:
+      return "portable";
+  }
+}
+
+/**
+ * Load consecutive elements starting at p into v (a scalar or a vector).
+ *
+ * Vectors are only passed by reference, passing the wide vectors by value
+ * would depend on the instruction set the caller is compiled for.
+ */
+template<typename V, typename T>
+LIBINTEGRATE_ALWAYS_INLINE void loadVector(V& v, const T* p)
+{
+  std::memcpy(&v, p, sizeof(V));
+}
+
+/**
+ * Compute the term of the interval(s) starting at x and y for the Riemann
+ * and trapezoid rules (the trapezoid term is not divided by 2).
+ * These are called with scalars and vectors.
+ */
+struct RiemannInterval {
+  template<typename V, typename T>
+  static LIBINTEGRATE_ALWAYS_INLINE void term(V& t, const T* x, const T* y)
+  {
+    V x0, x1;
+    loadVector(x0, x);
+    loadVector(x1, x + 1);
+    loadVector(t, y);
+    t *= x1 - x0;
+  }
+};
+struct TrapezoidInterval {
+  template<typename V, typename T>
+  static LIBINTEGRATE_ALWAYS_INLINE void term(V& t, const T* x, const T* y)
+  {
+    V x0, x1, y1;
+    loadVector(x0, x);
+    loadVector(x1, x + 1);
+    loadVector(t, y);
+    loadVector(y1, y + 1);
+    t = (t + y1) * (x1 - x0);
+  }
+};
+
+/**
+ * The product of the elements at x and y, so that the sum of the terms over
+ * [0,n) is a dot product (only n elements of x and y are read).
+ */
+struct Product {
+  template<typename V, typename T>
+  static LIBINTEGRATE_ALWAYS_INLINE void term(V& t, const T* x, const T* y)
+  {
+    V x0;
+    loadVector(x0, x);
+    loadVector(t, y);
+    t *= x0;
+  }
+};
+
+/**
+ * A vector of Bytes bytes of T, or T itself if Bytes == sizeof(T).
+ */
+template<typename T, std::size_t Bytes, typename = void>
+struct VectorType {
+  using type = T;
+};
+#if defined(LIBINTEGRATE_VECTOR_EXTENSIONS)
+template<typename T, std::size_t Bytes>
+struct VectorType<T, Bytes, std::enable_if_t<(Bytes > sizeof(T))>> {
+  typedef T type __attribute__((vector_size(Bytes)));
+};
+#endif
+
+template<std::size_t W, typename V>
+LIBINTEGRATE_ALWAYS_INLINE auto lane(const V& v, std::size_t l)
+{
+  if constexpr(W == 1)
+    return v;
+  else
+    return v[l];
+}
+
+/**
+ * The running sums of summation policy S in each lane of V (a vector or a scalar).
+ *
+ * Naive and Pairwise keep one sum in each lane. Neumaier and DoubleDouble
+ * also keep the rounding error of each lane, computed with the branch free
+ * TwoSum so that it can be vectorized.
+ */
+template<typename S, typename V>
+struct LaneSums {
+  V sum = {};
+
+  LIBINTEGRATE_ALWAYS_INLINE void add(const V& v) { sum += v; }
+
+  template<std::size_t W, typename A>
+  LIBINTEGRATE_ALWAYS_INLINE void reduce(A& acc) const
+  {
+    for(std::size_t l = 0; l < W; ++l) acc.add(lane<W>(sum, l));
+  }
+};
+
+template<typename V>
+struct CompensatedLaneSums {
+  V sum = {};
+  V c   = {};
+
+  LIBINTEGRATE_ALWAYS_INLINE void add(const V& v)
+  {
+    V t  = sum + v;
+    V bp = t - sum;
+    c += (sum - (t - bp)) + (v - bp);
+    sum = t;
+  }
+
+  template<std::size_t W, typename A>
+  LIBINTEGRATE_ALWAYS_INLINE void reduce(A& acc) const
+  {
+    for(std::size_t l = 0; l < W; ++l) acc.add(lane<W>(sum, l));
+    for(std::size_t l = 0; l < W; ++l) acc.add(lane<W>(c, l));
+  }
+};
+template<typename V>
+struct LaneSums<summation::Neumaier, V> : CompensatedLaneSums<V> {
+};
+template<typename V>
+struct LaneSums<summation::DoubleDouble, V> : CompensatedLaneSums<V> {
+};
+
+// the kernels accumulate into this many independent vectors (or scalars in the portable versions).
+inline constexpr std::size_t simdAccumulators = 8;
+
+// the number of loads into each lane before the lanes are added to a Pairwise accumulator.
+template<typename S, typename T>
+inline constexpr std::size_t laneRunSize = std::is_same_v<S, summation::Pairwise> ? summation::Pairwise::Accumulator<T>::RunSize : 0;
+
+/**
+ * Compute sum_i w_i y[i] over [0,n) with summation policy S, where w_i is
+ * we for even i and wo for odd i, with vectors of Bytes bytes.
+ */
+template<std::size_t Bytes, typename S, typename T>
+LIBINTEGRATE_ALWAYS_INLINE summation::Accumulator<S, T> weightedSumKernel(const T* y, std::size_t n, T we, T wo)
+{
+  using V                 = typename VectorType<T, Bytes>::type;
+  constexpr std::size_t W = Bytes / sizeof(T);
+  constexpr std::size_t A = simdAccumulators;
+  constexpr std::size_t R = laneRunSize<S, T>;
+
+  // the weights of a load that starts at an even (odd) index. All loads
+  // start at even indices, except in the scalar version.
+  V w[2];
+  if constexpr(W == 1) {
+    w[0] = we;
+    w[1] = wo;
+  } else {
+    for(std::size_t l = 0; l < W; ++l) {
+      w[0][l] = l % 2 ? wo : we;
+      w[1][l] = l % 2 ? we : wo;
+    }
+  }
+
+  summation::Accumulator<S, T> acc;
+  LaneSums<S, V>               lanes[A];
+  V                            v;
+  std::size_t                  i = 0, runs = 0;
+  for(; i + A * W <= n; i += A * W) {
+    for(std::size_t k = 0; k < A; ++k) {
+      loadVector(v, y + i + k * W);
+      v *= w[(k * W) % 2];
+      lanes[k].add(v);
+    }
+    if constexpr(R > 0)
+      if(++runs == R) {
+        for(std::size_t k = 0; k < A; ++k) {
+          lanes[k].template reduce<W>(acc);
+          lanes[k] = LaneSums<S, V>();
+        }
+        runs = 0;
+      }
+  }
+  for(; i + W <= n; i += W) {
+    loadVector(v, y + i);
+    v *= w[i % 2];
+    lanes[0].add(v);
+  }
+  for(std::size_t k = 0; k < A; ++k) lanes[k].template reduce<W>(acc);
+  for(; i < n; ++i) acc.add(y[i] * (i % 2 ? wo : we));
+  return acc;
+}
+
+/**
+ * Compute the sum of Op::term over the intervals i = 0,...,n-1 with
+ * summation policy S (x and y must have n+1 elements, or n for Product), with vectors of Bytes bytes.
+ */
+template<std::size_t Bytes, typename S, typename Op, typename T>
+LIBINTEGRATE_ALWAYS_INLINE summation::Accumulator<S, T> intervalSumKernel(const T* x, const T* y, std::size_t n)
+{
+  using V                 = typename VectorType<T, Bytes>::type;
+  constexpr std::size_t W = Bytes / sizeof(T);
+  constexpr std::size_t A = simdAccumulators;
+  constexpr std::size_t R = laneRunSize<S, T>;
+
+  summation::Accumulator<S, T> acc;
+  LaneSums<S, V>               lanes[A];
+  V                            t;
+  std::size_t                  i = 0, runs = 0;
+  for(; i + A * W <= n; i += A * W) {
+    for(std::size_t k = 0; k < A; ++k) {
+      Op::term(t, x + i + k * W, y + i + k * W);
+      lanes[k].add(t);
+    }
+    if constexpr(R > 0)
+      if(++runs == R) {
+        for(std::size_t k = 0; k < A; ++k) {
+          lanes[k].template reduce<W>(acc);
+          lanes[k] = LaneSums<S, V>();
+        }
+        runs = 0;
+      }
+  }
+  for(; i + W <= n; i += W) {
+    Op::term(t, x + i, y + i);
+    lanes[0].add(t);
+  }
+  for(std::size_t k = 0; k < A; ++k) lanes[k].template reduce<W>(acc);
+  T s;
+  for(; i < n; ++i) {
+    Op::term(s, x + i, y + i);
+    acc.add(s);
+  }
+  return acc;
+}
+
+#if defined(LIBINTEGRATE_SIMD_DISPATCH)
+// The kernels are always inlined into these wrappers, so they are compiled
+// for the instruction set of the wrapper.
+template<typename S, typename T>
+__attribute__((target("avx2"))) summation::Accumulator<S, T> weightedSumAVX2(const T* y, std::size_t n, T we, T wo)
+{
+  return weightedSumKernel<32, S>(y, n, we, wo);
+}
+template<typename S, typename Op, typename T>
+__attribute__((target("avx2"))) summation::Accumulator<S, T> intervalSumAVX2(const T* x, const T* y, std::size_t n)
+{
+  return intervalSumKernel<32, S, Op>(x, y, n);
+}
+template<typename S, typename T>
+__attribute__((target("avx512f"))) summation::Accumulator<S, T> weightedSumAVX512(const T* y, std::size_t n, T we, T wo)
+{
+  return weightedSumKernel<64, S>(y, n, we, wo);
+}
+template<typename S, typename Op, typename T>
+__attribute__((target("avx512f"))) summation::Accumulator<S, T> intervalSumAVX512(const T* x, const T* y, std::size_t n)
+{
+  return intervalSumKernel<64, S, Op>(x, y, n);
+}
+#endif
+
+/**
+ * Compute sum_i w_i y[i] over [0,n) with summation policy S, where w_i is
+ * we for even i and wo for odd i.
+ *
+ * The level argument selects the implementation, it must not be wider than
+ * simdLevel(). Levels that were not compiled in fall back to the portable version.
+ */
+template<typename S, typename T>
+summation::Accumulator<S, T> weightedSum(SimdLevel level, const T* y, std::size_t n, T we = 1, T wo = 1)
+{
+  switch(level) {
+#if defined(LIBINTEGRATE_SIMD_DISPATCH)
+    case SimdLevel::avx512:
+      return weightedSumAVX512<S>(y, n, we, wo);
+    case SimdLevel::avx2:
+      return weightedSumAVX2<S>(y, n, we, wo);
+#endif
+#if defined(LIBINTEGRATE_VECTOR_EXTENSIONS)
+    case SimdLevel::sse2:
+      return weightedSumKernel<16, S>(y, n, we, wo);
+#endif
+    default:
+      return weightedSumKernel<sizeof(T), S>(y, n, we, wo);
+  }
+}
+
+template<typename S, typename T>
+summation::Accumulator<S, T> weightedSum(const T* y, std::size_t n, T we = 1, T wo = 1)
+{
+  return weightedSum<S>(simdLevel(), y, n, we, wo);
+}
+
+/**
+ * Compute the sum of Op::term over the intervals i = 0,...,n-1 with summation
+ * policy S (x and y must have n+1 elements, or n for Product).
+ *
+ * Op::term(t, x + i, y + i) sets t to the term of interval i, or to the terms
+ * of the intervals i,...,i+W-1 if t is a vector of W elements (see
+ * RiemannInterval, TrapezoidInterval, and Product).
+ */
+template<typename S, typename Op, typename T>
+summation::Accumulator<S, T> intervalSum(SimdLevel level, const T* x, const T* y, std::size_t n)
+{
+  switch(level) {
+#if defined(LIBINTEGRATE_SIMD_DISPATCH)
+    case SimdLevel::avx512:
+      return intervalSumAVX512<S, Op>(x, y, n);
+    case SimdLevel::avx2:
+      return intervalSumAVX2<S, Op>(x, y, n);
+#endif
+#if defined(LIBINTEGRATE_VECTOR_EXTENSIONS)
+    case SimdLevel::sse2:
+      return intervalSumKernel<16, S, Op>(x, y, n);
+#endif
+    default:
+      return intervalSumKernel<sizeof(T), S, Op>(x, y, n);
+  }
+}
+
+template<typename S, typename Op, typename T>
+summation::Accumulator<S, T> intervalSum(const T* x, const T* y, std::size_t n)
+{
+  return intervalSum<S, Op>(simdLevel(), x, y, n);
+}
+
+/**
+ * Compute sum_i a[i] b[i] over [0,n) with summation policy S.
+ */
+template<typename S, typename T>
+summation::Accumulator<S, T> dot(const T* a, const T* b, std::size_t n)
+{
+  return intervalSum<S, Product>(a, b, n);
+}
+
+}  // namespace detail
+
+}  // namespace libIntegrate
@@ -0,0 +1,186 @@
+#pragma once
+
+/** @file Summation.hpp
+ * @brief Summation policies that select how the rules add up their terms
+ *
+ * Each rule takes a summation policy as a template parameter (Naive by
+ * default). A policy provides an Accumulator class template with
+ *
+ *   void add(T value);               // add one term
+ *   void add(const Accumulator &a);  // add the terms of another accumulator
+ *   T value() const;                 // the sum of all terms added so far
+ *
+ * The vectorized kernels in Simd.hpp keep one set of the policy's running
+ * sums in each vector lane, so the compensated policies are vectorized too.
+ * The accumulators are constexpr, so they can be used in integrals that are
+ * evaluated at compile time.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+namespace libIntegrate
+{
+namespace summation
+{
+/**
+ * Add each term to a single running sum. The error grows as O(N eps).
+ */
+struct Naive {
+  template<typename T>
+  class Accumulator
+  {
+   public:
+    constexpr void add(T v) { m_sum += v; }
+    constexpr void add(const Accumulator& a) { m_sum += a.m_sum; }
+    constexpr T    value() const { return m_sum; }
+
+   private:
+    T m_sum = 0;
+  };
+};
+
+/**
+ * Kahan-Babuska-Neumaier compensated summation. The rounding error of each
+ * addition is accumulated separately and added at the end, so the error is
+ * O(eps) independent of N (as long as the sum is not much smaller than the terms).
+ */
+struct Neumaier {
+  template<typename T>
+  class Accumulator
+  {
+   public:
+    constexpr void add(T v)
+    {
+      T t = m_sum + v;
+      if(abs(m_sum) >= abs(v))
+        m_c += (m_sum - t) + v;
+      else
+        m_c += (v - t) + m_sum;
+      m_sum = t;
+    }
+    constexpr void add(const Accumulator& a)
+    {
+      add(a.m_sum);
+      m_c += a.m_c;
+    }
+    constexpr T value() const { return m_sum + m_c; }
+
+   private:
+    // std::abs is not constexpr.
+    static constexpr T abs(T v) { return v < 0 ? -v : v; }
+
+    T m_sum = 0;
+    T m_c   = 0;
+  };
+};
+
+/**
+ * Pairwise (cascade) summation. Terms are added in short runs, and the run
+ * sums are combined in a binary tree as they are completed, so the error
+ * grows as O(log N eps) with O(log N) memory.
+ */
+struct Pairwise {
+  template<typename T>
+  class Accumulator
+  {
+   public:
+    static constexpr std::size_t RunSize = 16;
+
+    constexpr void add(T v)
+    {
+      m_run += v;
+      if(++m_runSize == RunSize) {
+        push(m_run);
+        m_run     = 0;
+        m_runSize = 0;
+      }
+    }
+    constexpr void add(const Accumulator& a) { add(a.value()); }
+    constexpr T    value() const
+    {
+      T sum = m_run;
+      for(std::size_t k = 0; k < Levels; k++)
+        if((m_runs >> k) & 1) sum += m_levels[k];
+      return sum;
+    }
+
+   private:
+    static constexpr std::size_t Levels = 64;
+
+    // m_levels[k] holds the sum of 2^k runs if bit k of m_runs is set.
+    constexpr void push(T s)
+    {
+      std::size_t k = 0;
+      for(std::size_t r = m_runs; r & 1; r >>= 1, k++) s = m_levels[k] + s;
+      m_levels[k] = s;
+      m_runs++;
+    }
+
+    T           m_run     = 0;
+    std::size_t m_runSize = 0;
+    std::size_t m_runs    = 0;
+    T           m_levels[Levels] = {};
+  };
+};
+
+/**
+ * Keep the sum as an unevaluated pair hi + lo (double-double arithmetic for
+ * T = double), which is roughly twice as precise as T. Each term is added with
+ * an error-free transformation and the pair is renormalized.
+ */
+struct DoubleDouble {
+  template<typename T>
+  class Accumulator
+  {
+   public:
+    constexpr void add(T v)
+    {
+      T s  = m_hi + v;
+      T bp = s - m_hi;
+      T e  = (m_hi - (s - bp)) + (v - bp) + m_lo;
+      m_hi = s + e;
+      m_lo = e - (m_hi - s);
+    }
+    constexpr void add(const Accumulator& a)
+    {
+      add(a.m_hi);
+      add(a.m_lo);
+    }
+    constexpr T value() const { return m_hi + m_lo; }
+
+   private:
+    T m_hi = 0;
+    T m_lo = 0;
+  };
+};
+
+template<typename S>
+struct is_summation_policy : std::false_type {
+};
+template<>
+struct is_summation_policy<Naive> : std::true_type {
+};
+template<>
+struct is_summation_policy<Neumaier> : std::true_type {
+};
+template<>
+struct is_summation_policy<Pairwise> : std::true_type {
+};
+template<>
+struct is_summation_policy<DoubleDouble> : std::true_type {
+};
+
+template<typename S>
+inline constexpr bool is_summation_policy_v = is_summation_policy<S>::value;
+
+/**
+ * The accumulator of summation policy S for type T.
+ */
+template<typename S, typename T>
+using Accumulator = typename S::template Accumulator<T>;
+
+}  // namespace summation
+
+}  // namespace libIntegrate
@@ -0,0 +1,224 @@
+#pragma once
+#include<cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "./Utils.hpp"
+#include "./RandomAccessLambda.hpp"
+#include "../Execution.hpp"
+#include "../Integrand.hpp"
+#include "../Summation.hpp"
+
+namespace _1D {
+
+/** @class
+  * @brief A class that integrates a natural cubic spline through a discretized function exactly.
+  *
+  * The spline is fit to all of the points (with zero second derivative at the
+  * end points), and each cubic segment is integrated in closed form
+  *
+  * \int_{x_i}^{x_{i+1}} s(x) dx = h (y_i + y_{i+1})/2 - h^3 (M_i + M_{i+1})/24
+  *
+  * where h = x_{i+1} - x_i and M_i is the second derivative of the spline at x_i.
+  * Fitting the spline is a single tridiagonal solve, so integrating N points is O(N).
+  * The segment integrals are added with the summation policy S (see Summation.hpp).
+  */
+template<typename T, std::size_t NN = 0, typename S = libIntegrate::summation::Naive>
+class CubicSplineRule
+{
+    using Accumulator_ = libIntegrate::summation::Accumulator<S,T>;
+
+  public:
+    CubicSplineRule() = default;
+
+    /*
+     * Integrate a discretized function from the set of argument and function values.
+     *
+     * The spline is always fit to *all* of the points, so integrating a sub-range
+     * [x[ai],x[bi]] gives the same result as the corresponding part of the
+     * integral over the whole range.
+     *
+     * Pass libIntegrate::execution::par as the first argument to sum the
+     * segment integrals in parallel (fitting the spline is always serial).
+     * The result is bitwise identical with either policy and any number of threads.
+     */
+    template<typename X, typename Y>
+    auto operator()( const X &x, const Y &y, long ai = 0, long bi = -1 ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),T())
+    {
+      return this->operator()(libIntegrate::execution::seq, x, y, ai, bi);
+    }
+
+    template<typename P, typename X, typename Y, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+    auto operator()( P policy, const X &x, const Y &y, long ai = 0, long bi = -1 ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),T())
+    {
+      using libIntegrate::getSize;
+      using libIntegrate::getElement;
+      T sum = 0;
+
+      auto N = getSize(x);
+      if(N == 0)
+        return sum;
+
+      // support for negative indices.
+      // interpret -n to mean the N-n index
+      while( ai < 0 )
+        ai += N;
+      while( bi < 0 )
+        bi += N;
+
+      auto M = SecondDerivatives(x, y);
+      sum = libIntegrate::detail::blockedSum<Accumulator_>(policy, ai, bi, [&x, &y, &M](long b, long e) {
+        Accumulator_ s;
+        for(long i = b; i < e; i++)
+          s.add(Segment(x, y, M, i));
+        return s;
+      }).value();
+
+      return sum;
+    }
+
+    /*
+     * Compute the cumulative integral of a discretized function in one pass.
+     * Element i of the returned vector is the integral from x[0] to x[i],
+     * i.e. the same as operator()(x,y,0,i).
+     *
+     * Pass libIntegrate::execution::par as the first argument to compute the
+     * segment integrals and the running sum in parallel (fitting the spline is
+     * always serial).
+     */
+    template<typename X, typename Y>
+    auto cumulative( const X &x, const Y &y ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),std::vector<T>())
+    {
+      return cumulative(libIntegrate::execution::seq, x, y);
+    }
+
+    template<typename P, typename X, typename Y, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+    auto cumulative( P policy, const X &x, const Y &y ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),std::vector<T>())
+    {
+      using libIntegrate::getSize;
+
+      long N = getSize(x);
+      std::vector<T> sum(N);
+      if(N < 2)
+        return sum;
+
+      auto M = SecondDerivatives(x, y);
+      libIntegrate::detail::forEachIndex(policy, 1, N, [&](long i) { sum[i] = Segment(x, y, M, i-1); });
+      libIntegrate::detail::inclusiveScan(policy, sum);
+
+      return sum;
+    }
+
+    /*
+     * Integrate a discretized function assuming uniform spacing.
+     */
+    template<typename Y>
+    auto operator()( const Y &y, T dx = 1 ) const -> decltype(libIntegrate::getSize(y),dx*libIntegrate::getElement(y,0),T())
+    {
+      using libIntegrate::getSize;
+      return this->operator()(
+          _1D::RandomAccessLambda(
+            [&dx](long i){return i*dx;},
+            [&y](){return getSize(y);}
+            ),
+          y );
+    }
+
+    /*
+     * Integrate a callable between two points by
+     * dividing it into a given number of intervals.
+     *
+     * f may return a vector of values (see Integrand.hpp). It is evaluated
+     * once at each point, and the spline of each component is integrated.
+     */
+    template<typename F>
+    auto operator()( F f, T a, T b, std::size_t N ) const -> libIntegrate::detail::IntegralOf<T,F,T>
+    {
+      using R = libIntegrate::detail::IntegralOf<T,F,T>;
+      T dx = (b-a)/N;
+      auto X = _1D::RandomAccessLambda(
+            [&a,&dx](long i){return a + i*dx;},
+            [&N](){return N+1;} // N here means number of intervals. In the discretized functions, it means the number of points.
+            );
+      if constexpr(libIntegrate::detail::isVectorValue_v<T,R>)
+      {
+        std::vector<R> values;
+        values.reserve(N+1);
+        for(std::size_t i = 0; i <= N; i++)
+          values.push_back(f(a + i*dx));
+        return libIntegrate::detail::integrateComponents(values, [&](auto y) {
+          return this->operator()(X, _1D::RandomAccessLambda(y, [&N](){return N+1;}));
+        });
+      }
+      else
+      {
+        return
+        this->operator()(
+            X,
+            _1D::RandomAccessLambda(
+              [&a,&dx,&f](long i){ return f(a + i*dx); },
+              [&N](){return N+1;}
+              )
+        );
+      }
+    }
+
+    /*
+     * Integrate a callable between two points by
+     * dividing it into a given number of intervals set at compile time.
+     */
+    template<typename F>
+    auto operator()( F f, T a, T b) const -> libIntegrate::detail::IntegralOf<T,F,T>
+    {
+      return this->operator()(f,a,b,NN);
+    }
+
+  protected:
+    /*
+     * Compute the second derivatives of the natural cubic spline through the points.
+     * The continuity conditions give the tridiagonal system
+     *
+     * h_{i-1} M_{i-1} + 2(h_{i-1}+h_i) M_i + h_i M_{i+1} = 6 [ (y_{i+1}-y_i)/h_i - (y_i-y_{i-1})/h_{i-1} ]
+     *
+     * with M_0 = M_{N-1} = 0, which is solved with the Thomas algorithm.
+     */
+    template<typename X, typename Y>
+    static std::vector<T> SecondDerivatives( const X &x, const Y &y )
+    {
+      using libIntegrate::getSize;
+      using libIntegrate::getElement;
+
+      long N = getSize(x);
+      std::vector<T> M(N);
+      if(N < 3)
+        return M;
+
+      // forward elimination, the modified super-diagonal is stored in c
+      std::vector<T> c(N, T(0));
+      for(long i = 1; i < N-1; i++)
+      {
+        T h0 = getElement(x,i) - getElement(x,i-1);
+        T h1 = getElement(x,i+1) - getElement(x,i);
+        T d = 6*( (getElement(y,i+1)-getElement(y,i))/h1 - (getElement(y,i)-getElement(y,i-1))/h0 );
+        T b = 2*(h0+h1) - h0*c[i-1];
+        c[i] = h1/b;
+        M[i] = (d - h0*M[i-1])/b;
+      }
+      // back substitution
+      for(long i = N-3; i > 0; i--)
+        M[i] -= c[i]*M[i+1];
+
+      return M;
+    }
+
+    // integrate the spline segment [x[i],x[i+1]].
+    template<typename X, typename Y>
+    static T Segment( const X &x, const Y &y, const std::vector<T> &M, long i )
+    {
+      using libIntegrate::getElement;
+      T h = getElement(x,i+1) - getElement(x,i);
+      return h*(getElement(y,i) + getElement(y,i+1))/2 - h*h*h*(M[i] + M[i+1])/24;
+    }
+};
+
+}
@@ -9,6 +9,9 @@
 #include<cstddef>
 #include<array>
 
+#include "../../Integrand.hpp"
+#include "../../Summation.hpp"
+
 namespace _1D {
 namespace GQ {
 
@@ -22,34 +25,40 @@ class GaussLegendreQuadrature_imp
 
     template<typename T>
     struct GetType{ };
-    template<template <typename,std::size_t> class Class, typename T, std::size_t Order>
-    struct GetType<Class<T,Order>> { using type = T; };
+    template<template <typename,std::size_t,typename> class Class, typename T, std::size_t Order, typename S>
+    struct GetType<Class<T,Order,S>> { using type = T; };
 
     template<typename T>
     struct GetOrder{ };
-    template<template <typename,std::size_t> class Class, typename T, std::size_t Order>
-    struct GetOrder<Class<T,Order>> { static const std::size_t value = Order; };
+    template<template <typename,std::size_t,typename> class Class, typename T, std::size_t Order, typename S>
+    struct GetOrder<Class<T,Order,S>> { static const std::size_t value = Order; };
+
+    template<typename T>
+    struct GetPolicy{ };
+    template<template <typename,std::size_t,typename> class Class, typename T, std::size_t Order, typename S>
+    struct GetPolicy<Class<T,Order,S>> { using type = S; };
 
     using DataType = typename GetType<Derived>::type;
 
-    // This version will integrate a callable between two points
+    // This version will integrate a callable between two points.
+    // f may return a vector of values (see Integrand.hpp), and each component is integrated.
     template<typename F>
-    DataType operator()( F f, DataType a, DataType b ) const
+    auto operator()( F f, DataType a, DataType b ) const -> libIntegrate::detail::IntegralOf<DataType,F,DataType>
     {
       static auto x = Derived::getX();
       static auto w = Derived::getW();
 
       using T = typename GetType<Derived>::type;
+      using R = libIntegrate::detail::IntegralOf<T,F,T>;
 
       T apb = static_cast<T>(b + a)/2;
       T amb = static_cast<T>(b - a)/2;
 
-      typename GetType<Derived>::type sum = 0;
+      libIntegrate::detail::IntegrandAccumulator<typename GetPolicy<Derived>::type,T,R> sum;
       for(std::size_t i = 0; i < GetOrder<Derived>::value; i++)
-        sum += w[i]*f( apb + amb*x[i] );
-      sum *= amb;
+        sum.add( w[i], f( apb + amb*x[i] ) );
 
-      return sum;
+      return libIntegrate::detail::scaled(sum.value(), amb);
     }
 
 };
@@ -65,14 +74,16 @@ class GaussLegendreQuadrature_imp
   * expects there to be a getX and getW function that return std::arrays<T,Order> references
   * to the weight and abscissa. The function should create and return static arrays so that
   * these arrays are only created once for each order.
+  *
+  * The weighted function values are added with the summation policy S (see Summation.hpp).
   */
-template<typename T, std::size_t Order>
+template<typename T, std::size_t Order, typename S = libIntegrate::summation::Naive>
 class GaussLegendreQuadrature
 {
 };
 
-template<typename T>
-class GaussLegendreQuadrature<T,8> : public detail::GaussLegendreQuadrature_imp<GaussLegendreQuadrature<T,8>>
+template<typename T, typename S>
+class GaussLegendreQuadrature<T,8,S> : public detail::GaussLegendreQuadrature_imp<GaussLegendreQuadrature<T,8,S>>
 {
 
   public:
@@ -107,8 +118,8 @@ class GaussLegendreQuadrature<T,8> : public detail::GaussLegendreQuadrature_imp<
 };
 
 
-template<typename T>
-class GaussLegendreQuadrature<T,16> : public detail::GaussLegendreQuadrature_imp<GaussLegendreQuadrature<T,16>>
+template<typename T, typename S>
+class GaussLegendreQuadrature<T,16,S> : public detail::GaussLegendreQuadrature_imp<GaussLegendreQuadrature<T,16,S>>
 {
 
   public:
@@ -158,8 +169,8 @@ class GaussLegendreQuadrature<T,16> : public detail::GaussLegendreQuadrature_imp
 
 };
 
-template<typename T>
-class GaussLegendreQuadrature<T,32> : public detail::GaussLegendreQuadrature_imp<GaussLegendreQuadrature<T,32>>
+template<typename T, typename S>
+class GaussLegendreQuadrature<T,32,S> : public detail::GaussLegendreQuadrature_imp<GaussLegendreQuadrature<T,32,S>>
 {
 
   public:
@@ -241,8 +252,8 @@ class GaussLegendreQuadrature<T,32> : public detail::GaussLegendreQuadrature_imp
 
 };
 
-template<typename T>
-class GaussLegendreQuadrature<T,64> : public detail::GaussLegendreQuadrature_imp<GaussLegendreQuadrature<T,64>>
+template<typename T, typename S>
+class GaussLegendreQuadrature<T,64,S> : public detail::GaussLegendreQuadrature_imp<GaussLegendreQuadrature<T,64,S>>
 {
 
   public:
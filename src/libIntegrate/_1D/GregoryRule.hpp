@@ -0,0 +1,154 @@
+#pragma once
+#include<cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "./Utils.hpp"
+#include "./RandomAccessLambda.hpp"
+#include "./TrapezoidRule.hpp"
+#include "../Execution.hpp"
+#include "../Integrand.hpp"
+#include "../Summation.hpp"
+
+namespace _1D {
+
+/** @class
+  * @brief A class that implements the trapezoid rule with Gregory end corrections.
+  *
+  * The trapezoid sum is corrected at each end with the first and second
+  * differences of the data,
+  *
+  * I = T + h/12 (Δy_0 - ∇y_n) - h/24 (Δ²y_0 + ∇²y_n)
+  *
+  * which changes the weights of the first and last three points to
+  * 3/8, 7/6, 23/24 and makes the error O(h^4) instead of O(h^2) for the
+  * same points. The corrections assume the points are equally spaced near
+  * each end; for non-uniform data use CubicSplineRule instead.
+  *
+  * The trapezoid sum is computed with the summation policy S (see Summation.hpp).
+  */
+template<typename T, std::size_t NN = 0, typename S = libIntegrate::summation::Naive>
+class GregoryRule
+{
+  public:
+    GregoryRule() = default;
+
+    /*
+     * Integrate a discretized function from the set of argument and function values.
+     *
+     * The interior is integrated with the trapezoid rule using the actual spacing
+     * of the points, and the end corrections use the mean spacing of the first
+     * (last) two intervals. Fewer than three points fall back to the trapezoid rule.
+     *
+     * Pass libIntegrate::execution::par as the first argument to compute the
+     * trapezoid sum in parallel, see TrapezoidRule.
+     */
+    template<typename X, typename Y>
+    auto operator()( const X &x, const Y &y, long ai = 0, long bi = -1 ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),T())
+    {
+      return this->operator()(libIntegrate::execution::seq, x, y, ai, bi);
+    }
+
+    template<typename P, typename X, typename Y, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+    auto operator()( P policy, const X &x, const Y &y, long ai = 0, long bi = -1 ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),T())
+    {
+      using libIntegrate::getSize;
+      using libIntegrate::getElement;
+      T sum = 0;
+
+      auto N = getSize(x);
+      if(N == 0)
+        return sum;
+
+      // support for negative indices.
+      // interpret -n to mean the N-n index
+      while( ai < 0 )
+        ai += N;
+      while( bi < 0 )
+        bi += N;
+
+      sum = TrapezoidRule<T,0,S>()(policy, x, y, ai, bi);
+
+      if(bi - ai < 2)
+        return sum;
+
+      T ha = (getElement(x,ai+2) - getElement(x,ai))/2;
+      T hb = (getElement(x,bi) - getElement(x,bi-2))/2;
+      sum += ha*EndCorrection(getElement(y,ai), getElement(y,ai+1), getElement(y,ai+2));
+      sum += hb*EndCorrection(getElement(y,bi), getElement(y,bi-1), getElement(y,bi-2));
+
+      return sum;
+    }
+
+    /*
+     * Integrate a discretized function assuming uniform spacing.
+     */
+    template<typename Y>
+    auto operator()( const Y &y, T dx = 1 ) const -> decltype(libIntegrate::getSize(y),dx*libIntegrate::getElement(y,0),T())
+    {
+      using libIntegrate::getSize;
+      return this->operator()(
+          _1D::RandomAccessLambda(
+            [&dx](long i){return i*dx;},
+            [&y](){return getSize(y);}
+            ),
+          y );
+    }
+
+    /*
+     * Integrate a callable between two points by
+     * dividing it into a given number of intervals.
+     *
+     * f may return a vector of values (see Integrand.hpp). It is evaluated
+     * once at each point, and each component is integrated.
+     */
+    template<typename F>
+    auto operator()( F f, T a, T b, std::size_t N ) const -> libIntegrate::detail::IntegralOf<T,F,T>
+    {
+      using R = libIntegrate::detail::IntegralOf<T,F,T>;
+      T dx = (b-a)/N;
+      if constexpr(libIntegrate::detail::isVectorValue_v<T,R>)
+      {
+        std::vector<R> values;
+        values.reserve(N+1);
+        for(std::size_t i = 0; i <= N; i++)
+          values.push_back(f(a + i*dx));
+        return libIntegrate::detail::integrateComponents(values, [&](auto y) {
+          return this->operator()(_1D::RandomAccessLambda(y, [&N](){return N+1;}), dx);
+        });
+      }
+      else
+      {
+        return
+        this->operator()(
+            _1D::RandomAccessLambda(
+              [&a,&dx,&f](long i){ return f(a + i*dx); },
+              [&N](){return N+1;} // N here means number of intervals. In the discretized functions, it means the number of points.
+              ),
+            dx
+        );
+      }
+    }
+
+    /*
+     * Integrate a callable between two points by
+     * dividing it into a given number of intervals set at compile time.
+     */
+    template<typename F>
+    auto operator()( F f, T a, T b) const -> libIntegrate::detail::IntegralOf<T,F,T>
+    {
+      return this->operator()(f,a,b,NN);
+    }
+
+  protected:
+    // the correction for one end of the interval, in units of the spacing.
+    // y0 is the end point, y1 and y2 are the next two points towards the interior.
+    // h/12 Δy_0 - h/24 Δ²y_0 = h (-y0/8 + y1/6 - y2/24)
+    template<typename Y0, typename Y1, typename Y2>
+    static T EndCorrection( Y0 y0, Y1 y1, Y2 y2 )
+    {
+      return -y0/T(8) + y1/T(6) - y2/T(24);
+    }
+};
+
+}
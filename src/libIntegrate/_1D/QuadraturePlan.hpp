@@ -0,0 +1,371 @@
+#pragma once
+
+/** @file QuadraturePlan.hpp
+ * @brief Precomputed quadrature weights for integrating many functions on the same grid.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "./Utils.hpp"
+#include "../_2D/Utils.hpp"
+#include "../Execution.hpp"
+#include "../Simd.hpp"
+#include "../Summation.hpp"
+
+namespace libIntegrate
+{
+namespace detail
+{
+/**
+ * Detects 2D containers of T that provide data(), rowStride() and colStride(),
+ * with element (i,j) at data()[i*rowStride() + j*colStride()] (e.g. _2D::Grid
+ * and the binary::GridView of IO.hpp).
+ */
+template<typename T, typename F, typename = void>
+struct hasStrides : std::false_type {
+};
+template<typename T, typename F>
+struct hasStrides<T, F,
+                  std::enable_if_t<std::is_same_v<decltype(std::declval<const F &>().data()), const T *> &&
+                                   std::is_integral_v<decltype(std::declval<const F &>().rowStride())> &&
+                                   std::is_integral_v<decltype(std::declval<const F &>().colStride())>>> : std::true_type {
+};
+template<typename T, typename F>
+inline constexpr bool hasStrides_v = hasStrides<T, F>::value;
+
+// Detects 2D containers whose rows are contiguous containers of T (e.g. std::vector<std::vector<T>>).
+template<typename T, typename F, typename = void>
+struct hasContiguousRows : std::false_type {
+};
+template<typename T, typename F>
+struct hasContiguousRows<T, F, std::enable_if_t<isContiguousOf_v<T, std::decay_t<decltype(std::declval<const F &>()[0])>>>>
+    : std::true_type {
+};
+}  // namespace detail
+}  // namespace libIntegrate
+
+namespace _1D
+{
+/**
+ * Which index of a 2D container selects the function in a batch (see QuadraturePlan::batch).
+ * With Rows, f(k,i) is point i of function k. With Columns, f(i,k) is point i of function k.
+ */
+enum class BatchLayout { Rows, Columns };
+
+/**
+ * The weights of a rule for a fixed set of argument values, so that the integral
+ * of any function values y on the same grid is the dot product sum_i w[i]*y[i].
+ *
+ * Creating the plan computes the weights once with the rule's weights(x,ai,bi)
+ * method (RiemannRule, TrapezoidRule and SimpsonRule provide one), which moves
+ * all of the work that depends on x (the interval widths, and the Lagrange
+ * polynomials of Simpson's rule) out of the integration. Only the weights of the
+ * integrated range are stored, and the dot product is vectorized for contiguous
+ * float and double data.
+ *
+ * Plans can be written to a stream or file and read back, so that they can be
+ * reused by later runs. The format is the "LIBINTQP" magic, followed by the size of
+ * T, the number of grid points, the index of the first weight and the number of
+ * weights (each a little-endian uint64), and then the little-endian weights.
+ *
+ * @code
+ * _1D::QuadraturePlan<double> plan(_1D::SimpsonRule<double>(), x);
+ * for(auto &y : spectra)
+ *   I.push_back(plan(y)); // same as _1D::SimpsonRule<double>()(x,y)
+ * @endcode
+ */
+template<typename T, typename S = libIntegrate::summation::Naive>
+class QuadraturePlan
+{
+  using Accumulator_ = libIntegrate::summation::Accumulator<S, T>;
+
+ public:
+  QuadraturePlan() = default;
+
+  /**
+   * Compute the weights of rule for the argument values x, integrating over [x[ai],x[bi]].
+   * Negative indices count from the end of x, like the rules.
+   */
+  template<typename Rule, typename X>
+  QuadraturePlan(const Rule &rule, const X &x, long ai = 0, long bi = -1) : QuadraturePlan(rule.weights(x, ai, bi))
+  {
+  }
+
+  /**
+   * Use the given weights, one for each point of the grid. Leading and trailing
+   * zero weights are dropped.
+   */
+  explicit QuadraturePlan(const std::vector<T> &weights) : m_size(weights.size())
+  {
+    std::size_t b = 0, e = weights.size();
+    while(b < e && weights[b] == 0) ++b;
+    while(e > b && weights[e - 1] == 0) --e;
+    m_offset = b;
+    m_weights.assign(weights.begin() + b, weights.begin() + e);
+  }
+
+  // the number of points of the grid the plan was created for.
+  std::size_t size() const { return m_size; }
+  // the index of the point that weights()[0] belongs to.
+  std::size_t offset() const { return m_offset; }
+  // the weights of the points offset(),...,offset()+weights().size()-1, the other weights are zero.
+  const std::vector<T> &weights() const { return m_weights; }
+
+  /**
+   * Integrate the function values y, which must have size() elements.
+   *
+   * Pass libIntegrate::execution::par as the first argument to compute the
+   * dot product in parallel. The result is bitwise identical with either policy.
+   */
+  template<typename Y>
+  auto operator()(const Y &y) const -> decltype(libIntegrate::getSize(y), libIntegrate::getElement(y, 0), T())
+  {
+    return this->operator()(libIntegrate::execution::seq, y);
+  }
+
+  template<typename P, typename Y, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+  auto operator()(P policy, const Y &y) const -> decltype(libIntegrate::getSize(y), libIntegrate::getElement(y, 0), T())
+  {
+    using libIntegrate::getElement;
+    using libIntegrate::getSize;
+
+    if(static_cast<std::size_t>(getSize(y)) != m_size)
+      throw std::runtime_error("QuadraturePlan was created for " + std::to_string(m_size) + " points, but the function has " +
+                               std::to_string(getSize(y)) + ".");
+
+    const T *w = m_weights.data();
+    long     o = m_offset;
+    return libIntegrate::detail::blockedSum<Accumulator_>(policy, 0, m_weights.size(), [&y, w, o](long b, long e) {
+             if constexpr(libIntegrate::detail::isContiguousOf_v<T, Y>) {
+               return libIntegrate::detail::dot<S>(w + b, std::data(y) + o + b, e - b);
+             } else {
+               Accumulator_ sum;
+               for(long i = b; i < e; i++) sum.add(w[i] * getElement(y, o + i));
+               return sum;
+             }
+           })
+        .value();
+  }
+
+  /**
+   * Integrate a batch of functions on the grid of the plan, and return the
+   * integral of each function. f is a 2D container with one function in each
+   * row (or column, see BatchLayout), accessed with getElement(f,i,j),
+   * getSizeX(f) and getSizeY(f).
+   *
+   * The integrals are computed in blocks of functions, and the points in tiles
+   * that are small enough to stay in cache, so each tile of weights is loaded once
+   * for the whole block. Containers with data(), rowStride() and colStride() (like
+   * _2D::Grid), and rows of contiguous containers, are read through pointers and
+   * rows are vectorized. Each integral is the same as operator()(y) up to rounding.
+   *
+   * Pass libIntegrate::execution::par as the first argument to integrate the
+   * blocks of functions in parallel. The result does not depend on the number of threads.
+   */
+  template<typename F>
+  auto batch(const F &f, BatchLayout layout = BatchLayout::Rows) const
+      -> decltype(libIntegrate::getSizeX(f), libIntegrate::getSizeY(f), libIntegrate::getElement(f, 0, 0), std::vector<T>())
+  {
+    return batch(libIntegrate::execution::seq, f, layout);
+  }
+
+  template<typename P, typename F, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+  auto batch(P policy, const F &f, BatchLayout layout = BatchLayout::Rows) const
+      -> decltype(libIntegrate::getSizeX(f), libIntegrate::getSizeY(f), libIntegrate::getElement(f, 0, 0), std::vector<T>())
+  {
+    using libIntegrate::getElement;
+    using libIntegrate::getSizeX;
+    using libIntegrate::getSizeY;
+
+    const bool     rows = layout == BatchLayout::Rows;
+    std::size_t    M    = rows ? getSizeX(f) : getSizeY(f);
+    std::vector<T> I(M);
+    if(M == 0) return I;
+
+    std::size_t N = rows ? getSizeY(f) : getSizeX(f);
+    if(N != m_size)
+      throw std::runtime_error("QuadraturePlan was created for " + std::to_string(m_size) + " points, but the functions have " +
+                               std::to_string(N) + ".");
+
+    if constexpr(libIntegrate::detail::hasStrides_v<T, F>) {
+      const T       *p  = f.data();
+      std::ptrdiff_t sk = rows ? f.rowStride() : f.colStride();
+      std::ptrdiff_t si = rows ? f.colStride() : f.rowStride();
+      batchStrided(policy, I, [p, sk](std::size_t k) { return p + static_cast<std::ptrdiff_t>(k) * sk; }, si, sk == 1);
+      return I;
+    }
+    if constexpr(libIntegrate::detail::hasContiguousRows<T, F>::value) {
+      if(rows) {
+        batchStrided(policy, I, [&f](std::size_t k) { return std::data(f[k]); }, 1, false);
+        return I;
+      }
+    }
+
+    const T *w = m_weights.data();
+    long     n = m_weights.size(), o = m_offset;
+    libIntegrate::detail::forEachIndex(policy, 0, M, [&](long k) {
+      Accumulator_ sum;
+      for(long i = 0; i < n; i++) sum.add(w[i] * (rows ? getElement(f, k, o + i) : getElement(f, o + i, k)));
+      I[k] = sum.value();
+    });
+    return I;
+  }
+
+  // Write the plan in binary form (see the class description).
+  void write(std::ostream &out) const
+  {
+    requireLittleEndian();
+    out.write(magic, 8);
+    writeUInt64(out, sizeof(T));
+    writeUInt64(out, m_size);
+    writeUInt64(out, m_offset);
+    writeUInt64(out, m_weights.size());
+    out.write(reinterpret_cast<const char *>(m_weights.data()), m_weights.size() * sizeof(T));
+    if(!out) throw std::runtime_error("Failed to write QuadraturePlan.");
+  }
+
+  void write(const std::string &filename) const
+  {
+    std::ofstream out(filename, std::ios::binary);
+    if(!out) throw std::runtime_error("Failed to open file: " + filename);
+    write(out);
+  }
+
+  // Read a plan written by write(). Throws a std::runtime_error if the data is not a valid plan for T.
+  static QuadraturePlan read(std::istream &in)
+  {
+    requireLittleEndian();
+    char m[8] = {};
+    in.read(m, 8);
+    if(!in || std::memcmp(m, magic, 8) != 0) throw std::runtime_error("Not a QuadraturePlan.");
+
+    std::uint64_t bytes = readUInt64(in);
+    if(bytes != sizeof(T))
+      throw std::runtime_error("QuadraturePlan has " + std::to_string(bytes) + " byte weights, expected " + std::to_string(sizeof(T)) + ".");
+
+    QuadraturePlan plan;
+    plan.m_size         = readUInt64(in);
+    plan.m_offset       = readUInt64(in);
+    std::uint64_t count = readUInt64(in);
+    if(plan.m_offset > plan.m_size || count > plan.m_size - plan.m_offset || count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+      throw std::runtime_error("Corrupt QuadraturePlan header.");
+
+    // the count comes from the stream, so the weights are read in chunks, and
+    // memory is only allocated for weights that are actually there.
+    const std::size_t chunk = std::size_t(1) << 16;
+    while(plan.m_weights.size() < count) {
+      std::size_t pos = plan.m_weights.size();
+      std::size_t n   = static_cast<std::size_t>(std::min<std::uint64_t>(chunk, count - pos));
+      plan.m_weights.resize(pos + n);
+      in.read(reinterpret_cast<char *>(plan.m_weights.data() + pos), n * sizeof(T));
+      if(!in) throw std::runtime_error("Truncated QuadraturePlan.");
+    }
+    return plan;
+  }
+
+  static QuadraturePlan read(const std::string &filename)
+  {
+    std::ifstream in(filename, std::ios::binary);
+    if(!in) throw std::runtime_error("Failed to open file: " + filename);
+    return read(in);
+  }
+
+ private:
+  static constexpr char magic[] = "LIBINTQP";
+
+  // the number of points in a tile of weights, and the number of functions in a block (see batch).
+  // interleaved blocks are wide so that each row of points is read in long runs.
+  static constexpr long batchTile             = 2048;
+  static constexpr long batchBlock            = 32;
+  static constexpr long batchInterleavedBlock = 1024;
+
+  /**
+   * Integrate the functions k = 0,...,I.size()-1, where point i of function k
+   * is at data(k)[i*si]. If the functions are interleaved, data(k+1) = data(k) + 1.
+   */
+  template<typename P, typename D>
+  void batchStrided(P policy, std::vector<T> &I, D data, std::ptrdiff_t si, bool interleaved) const
+  {
+    const T *w = m_weights.data();
+    long     M = I.size(), n = m_weights.size(), o = m_offset;
+
+    if(si == 1) {
+      // contiguous functions: dot products with each tile of weights, for all functions in the block.
+      libIntegrate::detail::forEachIndex(policy, 0, (M + batchBlock - 1) / batchBlock, [&](long b) {
+        long                      kb = b * batchBlock, ke = std::min(kb + batchBlock, M);
+        std::vector<Accumulator_> sums(ke - kb);
+        for(long t = 0; t < n; t += batchTile) {
+          long len = std::min(batchTile, n - t);
+          for(long k = kb; k < ke; k++) {
+            if constexpr(std::is_same_v<T, float> || std::is_same_v<T, double>)
+              sums[k - kb].add(libIntegrate::detail::dot<S>(w + t, data(k) + o + t, len));
+            else
+              for(long i = t; i < t + len; i++) sums[k - kb].add(w[i] * data(k)[o + i]);
+          }
+        }
+        for(long k = kb; k < ke; k++) I[k] = sums[k - kb].value();
+      });
+    } else if(interleaved) {
+      // point i of all of the functions in a block is contiguous: add w[i] times the block to the sums.
+      libIntegrate::detail::forEachIndex(policy, 0, (M + batchInterleavedBlock - 1) / batchInterleavedBlock, [&](long b) {
+        long                      kb = b * batchInterleavedBlock, ke = std::min(kb + batchInterleavedBlock, M);
+        std::vector<Accumulator_> sums(ke - kb);
+        const T                  *p = data(kb);
+        for(long i = 0; i < n; i++) {
+          const T *q = p + (o + i) * si;
+          for(long k = 0; k < ke - kb; k++) sums[k].add(w[i] * q[k]);
+        }
+        for(long k = kb; k < ke; k++) I[k] = sums[k - kb].value();
+      });
+    } else {
+      libIntegrate::detail::forEachIndex(policy, 0, M, [&](long k) {
+        Accumulator_ sum;
+        const T     *p = data(k);
+        for(long i = 0; i < n; i++) sum.add(w[i] * p[(o + i) * si]);
+        I[k] = sum.value();
+      });
+    }
+  }
+
+  static void requireLittleEndian()
+  {
+    const std::uint16_t one = 1;
+    unsigned char       first;
+    std::memcpy(&first, &one, 1);
+    if(first != 1) throw std::runtime_error("QuadraturePlan I/O requires a little-endian host.");
+  }
+
+  static void writeUInt64(std::ostream &out, std::uint64_t value)
+  {
+    char bytes[8];
+    for(std::size_t i = 0; i < 8; ++i) bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    out.write(bytes, 8);
+  }
+
+  static std::uint64_t readUInt64(std::istream &in)
+  {
+    char bytes[8] = {};
+    in.read(bytes, 8);
+    if(!in) throw std::runtime_error("Truncated QuadraturePlan header.");
+    std::uint64_t value = 0;
+    for(std::size_t i = 0; i < 8; ++i) value |= static_cast<std::uint64_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+    return value;
+  }
+
+  std::size_t    m_size   = 0;
+  std::size_t    m_offset = 0;
+  std::vector<T> m_weights;
+};
+
+}  // namespace _1D
@@ -1,8 +1,15 @@
 #pragma once
 #include<cstddef>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "./Utils.hpp"
+#include "../Execution.hpp"
+#include "../Integrand.hpp"
+#include "../Simd.hpp"
+#include "../Summation.hpp"
+#include "./QuadraturePlan.hpp"
 #include "./RandomAccessLambda.hpp"
 
 namespace _1D {
@@ -10,18 +17,63 @@ namespace _1D {
 /** @class 
   * @brief A class that implements Riemann sums.
   * @author C.D. Clark III
+  *
+  * The terms are added with the summation policy S (see Summation.hpp).
   */
-template<typename T, std::size_t NN = 0>
+template<typename T, std::size_t NN = 0, typename S = libIntegrate::summation::Naive>
 class RiemannRule
 {
+    using Accumulator_ = libIntegrate::summation::Accumulator<S,T>;
+
   public:
     RiemannRule() = default;
 
+    /**
+     * Accumulates a Riemann sum one point at a time, so that data can be
+     * integrated as it is read without storing it.
+     *
+     * value() returns the same result as integrating all of the points
+     * added so far with operator()(x,y) (up to rounding, operator()(x,y)
+     * sums contiguous arrays with several accumulators).
+     */
+    class Accumulator
+    {
+      public:
+        void add(T x, T y)
+        {
+          if(m_size > 0)
+            m_sum.add(m_y*(x-m_x));
+          m_x = x;
+          m_y = y;
+          ++m_size;
+        }
+
+        T value() const { return m_sum.value(); }
+        std::size_t size() const { return m_size; }
+
+      private:
+        Accumulator_ m_sum;
+        T m_x = 0;
+        T m_y = 0;
+        std::size_t m_size = 0;
+    };
+
     /*
      * Integrate a discretized function from the set of argument and function values.
+     *
+     * Pass libIntegrate::execution::par as the first argument to sum the
+     * intervals in parallel. The range is split into fixed-size blocks that
+     * do not depend on the number of threads, so the result is bitwise
+     * identical with either policy and any number of threads.
      */
     template<typename X, typename Y>
     auto operator()( const X &x, const Y &y, long ai = 0, long bi = -1 ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),T())
+    {
+      return this->operator()(libIntegrate::execution::seq, x, y, ai, bi);
+    }
+
+    template<typename P, typename X, typename Y, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+    auto operator()( P policy, const X &x, const Y &y, long ai = 0, long bi = -1 ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),T())
     {
       // we are using getSize and getElement here so we can support
       // containers that use methods other than .operator[](int) and .size()
@@ -43,12 +95,86 @@ class RiemannRule
       while( bi < 0 )
         bi += N;
 
-      for(long i = ai; i < bi; i++)
-        sum += getElement(y,i)*(getElement(x,i+1)-getElement(x,i));
+      return libIntegrate::detail::blockedSum<Accumulator_>(policy, ai, bi, [&x,&y](long b, long e) { return Sum(x, y, b, e); }).value();
+    }
+
+    /*
+     * Compute the cumulative integral of a discretized function in one pass.
+     * Element i of the returned vector is the integral from x[0] to x[i],
+     * i.e. the same as operator()(x,y,0,i).
+     *
+     * Pass libIntegrate::execution::par as the first argument to compute the
+     * interval sums and the running sum in parallel.
+     */
+    template<typename X, typename Y>
+    auto cumulative( const X &x, const Y &y ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),std::vector<T>())
+    {
+      return cumulative(libIntegrate::execution::seq, x, y);
+    }
+
+    template<typename P, typename X, typename Y, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+    auto cumulative( P policy, const X &x, const Y &y ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),std::vector<T>())
+    {
+      using libIntegrate::getSize;
+      using libIntegrate::getElement;
+
+      long N = getSize(x);
+      std::vector<T> sum(N);
+      libIntegrate::detail::forEachIndex(policy, 1, N, [&](long i) {
+        sum[i] = getElement(y,i-1)*(getElement(x,i)-getElement(x,i-1));
+      });
+      libIntegrate::detail::inclusiveScan(policy, sum);
 
       return sum;
     }
 
+    /*
+     * Compute the weight of each point, so that sum_i w[i]*y[i] is the same
+     * as operator()(x,y,ai,bi) (up to rounding) for any y. The weights of
+     * the points outside of [ai,bi] are zero. See QuadraturePlan.
+     */
+    template<typename X>
+    auto weights( const X &x, long ai = 0, long bi = -1 ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),std::vector<T>())
+    {
+      using libIntegrate::getSize;
+      using libIntegrate::getElement;
+
+      long N = getSize(x);
+      std::vector<T> w(N);
+      if(N == 0)
+        return w;
+
+      // support for negative indices.
+      // interpret -n to mean the N-n index
+      while( ai < 0 )
+        ai += N;
+      while( bi < 0 )
+        bi += N;
+
+      for(long i = ai; i < bi; i++)
+        w[i] = getElement(x,i+1) - getElement(x,i);
+
+      return w;
+    }
+
+    /*
+     * Integrate a batch of functions that share the argument values x, one
+     * function in each row (or column) of the 2D container f, and return
+     * the integrals. The same as QuadraturePlan<T,S>(*this,x).batch(f,layout),
+     * see QuadraturePlan::batch.
+     */
+    template<typename X, typename F>
+    auto batch( const X &x, const F &f, BatchLayout layout = BatchLayout::Rows ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getSizeX(f),std::vector<T>())
+    {
+      return batch(libIntegrate::execution::seq, x, f, layout);
+    }
+
+    template<typename P, typename X, typename F, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+    auto batch( P policy, const X &x, const F &f, BatchLayout layout = BatchLayout::Rows ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getSizeX(f),std::vector<T>())
+    {
+      return QuadraturePlan<T,S>(*this, x).batch(policy, f, layout);
+    }
+
     /*
      * Integrate a discretized function assuming uniform spacing.
      */
@@ -57,44 +183,98 @@ class RiemannRule
     {
       using libIntegrate::getSize;
       using libIntegrate::getElement;
-      T sum = 0;
-      for(decltype(getSize(y)) i = 0; i < getSize(y); i++)
-        sum += getElement(y,i);
-      sum *= dx;
+      Accumulator_ sum;
+      if constexpr(libIntegrate::detail::isContiguousOf_v<T,Y>)
+      {
+        sum = libIntegrate::detail::weightedSum<S>(std::data(y), getSize(y));
+      }
+      else
+      {
+        for(decltype(getSize(y)) i = 0; i < getSize(y); i++)
+          sum.add(getElement(y,i));
+      }
 
-      return sum;
+      return sum.value()*dx;
     }
 
     /*
      * Integrate a callable between two points by
      * dividing it into a given number of intervals.
+     *
+     * f may return a vector of values (see Integrand.hpp), and each component is integrated.
      */
     template<typename F>
-    T operator()( F f, T a, T b, std::size_t N ) const
+    auto operator()( F f, T a, T b, std::size_t N ) const -> libIntegrate::detail::IntegralOf<T,F,T>
     {
+      using R = libIntegrate::detail::IntegralOf<T,F,T>;
       T dx = (b-a)/N;
-      return
-      this->operator()(
-          _1D::RandomAccessLambda(
-            [&a,&dx](int i){return a + i*dx;},
-            [&N](){return N+1;} // N here means number of intervals. In the discretized functions, it means the number of points.
-            ),
-        [&a,&dx,&f](int i){ return f(a + i*dx); }
-      );
+      if constexpr(libIntegrate::detail::isVectorValue_v<T,R>)
+      {
+        libIntegrate::detail::IntegrandAccumulator<S,T,R> sum;
+        for(std::size_t i = 0; i < N; i++)
+          sum.add(f(a + i*dx));
+        return libIntegrate::detail::scaled(sum.value(), dx);
+      }
+      else
+      {
+        return
+        this->operator()(
+            _1D::RandomAccessLambda(
+              [&a,&dx](int i){return a + i*dx;},
+              [&N](){return N+1;} // N here means number of intervals. In the discretized functions, it means the number of points.
+              ),
+          [&a,&dx,&f](int i){ return f(a + i*dx); }
+        );
+      }
     }
 
     /*
      * Integrate a callable between two points by
      * dividing it into a given number of intervals set at compile time.
+     *
+     * For 0 < NN <= libIntegrate::detail::unrollLimit the sum is unrolled at
+     * compile time, and it is a constant expression if f is.
      */
     template<typename F>
-    T operator()( F f, T a, T b) const
+    constexpr auto operator()( F f, T a, T b) const -> libIntegrate::detail::IntegralOf<T,F,T>
     {
-      return this->operator()(f,a,b,NN);
+      if constexpr(NN > 0 && NN <= libIntegrate::detail::unrollLimit && !libIntegrate::detail::isVectorValue_v<T,libIntegrate::detail::IntegralOf<T,F,T>>)
+      {
+        T dx = (b-a)/NN;
+        return Unrolled(f, a, dx, std::make_index_sequence<NN>{})*dx;
+      }
+      else
+      {
+        return this->operator()(f,a,b,NN);
+      }
     }
 
 
   protected:
+    // sum the left end points a+I*dx, without the factor of dx.
+    template<typename F, std::size_t... I>
+    static constexpr T Unrolled( F &f, T a, T dx, std::index_sequence<I...> )
+    {
+      Accumulator_ sum;
+      (sum.add(f(a + I*dx)), ...);
+      return sum.value();
+    }
+
+    // sum the intervals [x[i],x[i+1]] for i in [ai,bi).
+    template<typename X, typename Y>
+    static Accumulator_ Sum( const X &x, const Y &y, long ai, long bi )
+    {
+      using libIntegrate::getElement;
+
+      // contiguous float and double arrays use the vectorized kernel
+      if constexpr(libIntegrate::detail::isContiguousOf_v<T,X> && libIntegrate::detail::isContiguousOf_v<T,Y>)
+        return libIntegrate::detail::intervalSum<S,libIntegrate::detail::RiemannInterval>(std::data(x)+ai, std::data(y)+ai, bi-ai);
+
+      Accumulator_ sum;
+      for(long i = ai; i < bi; i++)
+        sum.add(getElement(y,i)*(getElement(x,i+1)-getElement(x,i)));
+      return sum;
+    }
 };
 
 }
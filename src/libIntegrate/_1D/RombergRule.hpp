@@ -0,0 +1,101 @@
+#pragma once
+#include<cmath>
+#include<cstddef>
+#include<limits>
+#include<vector>
+
+#include "../Summation.hpp"
+#include "./TrapezoidRule.hpp"
+
+namespace _1D {
+
+/** @class
+  * @brief A class that implements Romberg integration.
+  *
+  * The trapezoid rule is applied with 1, 2, 4, ..., 2^k intervals. Each
+  * refinement only evaluates the new mid points (TrapezoidRule::refine), so
+  * level k costs 2^k + 1 evaluations in total. Richardson extrapolation of
+  * the trapezoid estimates
+  *
+  * R(k,j) = R(k,j-1) + (R(k,j-1) - R(k-1,j-1))/(4^j - 1)
+  *
+  * cancels the h^2, h^4, ..., h^2j error terms, and the difference between
+  * the last two diagonal entries R(k,k) and R(k-1,k-1) is the error estimate.
+  * Refinement stops when the error estimate is smaller than tol times the
+  * integral of |f| (so integrals that vanish converge too), or at max_level.
+  *
+  * The sums are added with the summation policy S (see Summation.hpp).
+  */
+template<typename T, typename S = libIntegrate::summation::Naive>
+class RombergRule
+{
+  public:
+    RombergRule() = default;
+
+    // the first level that is tested for convergence. the coarse levels can
+    // agree by chance (e.g. sin(2 pi x) on [0,1] vanishes at every node of levels 0 and 1).
+    static constexpr unsigned min_level = 3;
+
+    /**
+     * @param f function or functor to be integrated.
+     * @param a lower limit of integration.
+     * @param b upper limit of integration.
+     * @param max_level the maximum number of refinements (at most 2^max_level intervals).
+     * @param tol the relative tolerance.
+     * @param error if not null, set to the error estimate.
+     * @param evaluations if not null, set to the number of evaluations of f.
+     **/
+    template<typename F>
+    T operator()( F f, T a, T b, unsigned max_level, T tol, T* error = nullptr, std::size_t* evaluations = nullptr ) const
+    {
+      // integrate |f| along with f, from the same evaluations.
+      T l1_sum = 0;
+      auto g = [&f,&l1_sum](T x) { T y = f(x); l1_sum += std::abs(y); return y; };
+
+      T fa = g(a);
+      T fb = g(b);
+      T h = b-a;
+      T l1 = (l1_sum/2)*std::abs(h);
+      std::vector<T> previous = {(fa+fb)*(h/2)}, current;
+      std::size_t N = 1;
+
+      T estimate = std::numeric_limits<T>::infinity();
+      for(unsigned k = 1; k <= max_level; k++)
+      {
+        l1_sum = 0;
+        current.resize(k+1);
+        current[0] = m_trapezoid.refine(g, a, b, N, previous[0]);
+        l1 = l1/2 + l1_sum*std::abs(h/N)/2;
+        N *= 2;
+
+        T factor = 1;
+        for(unsigned j = 1; j <= k; j++)
+        {
+          factor *= 4;
+          current[j] = current[j-1] + (current[j-1] - previous[j-1])/(factor - 1);
+        }
+
+        estimate = std::abs(current[k] - previous[k-1]);
+        std::swap(previous, current);
+        if(k >= min_level && estimate <= tol*l1)
+          break;
+      }
+
+      if(error)
+        *error = estimate;
+      if(evaluations)
+        *evaluations = N + 1;
+      return previous.back();
+    }
+
+    template<typename F>
+    T operator()( F f, T a, T b ) const
+    {
+      return this->operator()(f, a, b, 20, std::sqrt(std::numeric_limits<T>::epsilon()));
+    }
+
+  protected:
+    TrapezoidRule<T,0,S> m_trapezoid;
+};
+
+}
@@ -1,29 +1,93 @@
 #pragma once
+#include <array>
 #include <cstddef>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "./Utils.hpp"
+#include "../Execution.hpp"
+#include "../Integrand.hpp"
+#include "../Simd.hpp"
+#include "../Summation.hpp"
+#include "./QuadraturePlan.hpp"
 
 namespace _1D
 {
 /** @class
  * @brief A class that implements Simposon's (1/3) rule.
  * @author C.D. Clark III
+ *
+ * The segments are added with the summation policy S (see Summation.hpp).
  */
-template<typename T, std::size_t NN = 0>
+template<typename T, std::size_t NN = 0, typename S = libIntegrate::summation::Naive>
 class SimpsonRule
 {
+  using Accumulator_ = libIntegrate::summation::Accumulator<S, T>;
+
  public:
   SimpsonRule() = default;
 
-  // This version will integrate a callable between two points
+  /**
+   * Accumulates a Simpson's rule sum one point at a time, so that data can
+   * be integrated as it is read without storing it. Only the last three
+   * points are kept.
+   *
+   * value() returns the same result as integrating all of the points added
+   * so far with operator()(x,y). If only two points have been added, the
+   * trapezoid rule is used since there are not enough points to fit a quadratic.
+   */
+  class Accumulator
+  {
+   public:
+    void add(T x, T y)
+    {
+      m_x[0] = m_x[1];
+      m_x[1] = m_x[2];
+      m_x[2] = x;
+      m_y[0] = m_y[1];
+      m_y[1] = m_y[2];
+      m_y[2] = y;
+      ++m_size;
+
+      // every other point completes a segment
+      if(m_size > 2 && m_size % 2 == 1)
+        m_sum.add(Segment(m_x[0], m_x[1], m_x[2], m_y[0], m_y[1], m_y[2]));
+    }
+
+    T value() const
+    {
+      if(m_size < 2 || m_size % 2 == 1)
+        return m_sum.value();
+
+      if(m_size == 2)
+        return (m_x[2] - m_x[1]) * (m_y[2] + m_y[1]) / 2;
+
+      // there is one extra interval at the end that is not part of a segment yet.
+      return m_sum.value() + EndInterval(m_x[0], m_x[1], m_x[2], m_y[0], m_y[1], m_y[2]);
+    }
+
+    std::size_t size() const { return m_size; }
+
+   private:
+    Accumulator_ m_sum;
+    T            m_x[3] = {0, 0, 0};
+    T            m_y[3] = {0, 0, 0};
+    std::size_t  m_size = 0;
+  };
+
+  // This version will integrate a callable between two points.
+  // f is evaluated once at each of the 2N+1 points, and it may return a
+  // vector of values (see Integrand.hpp), in which case each component is integrated.
   template<typename F, std::size_t NN_ = NN,
            typename SFINAE = typename std::enable_if<(NN_ == 0)>::type>
-  T operator()(F f, T a, T b, std::size_t N) const;
+  libIntegrate::detail::IntegralOf<T, F, T> operator()(F f, T a, T b, std::size_t N) const;
 
+  // For NN <= libIntegrate::detail::unrollLimit the sum is unrolled at compile time,
+  // and it is a constant expression if f is.
   template<typename F, std::size_t NN_ = NN,
            typename SFINAE = typename std::enable_if<(NN_ > 0)>::type>
-  T operator()(F f, T a, T b) const;
+  constexpr libIntegrate::detail::IntegralOf<T, F, T> operator()(F f, T a, T b) const;
 
   /**
    * This version will integrate a discretized function with the x and y
@@ -34,9 +98,20 @@ class SimpsonRule
    *
    * x and y must have the same size *and* contain 3 or more elements,
    * othersize the call is undefined behavior.
+   *
+   * Pass libIntegrate::execution::par as the first argument to sum the
+   * segments in parallel. The segments are split into fixed-size blocks that
+   * do not depend on the number of threads, so the result is bitwise
+   * identical with either policy and any number of threads.
    */
   template<typename X, typename Y>
   auto operator()( const X &x, const Y &y, long ai = 0, long bi = -1 ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),T())
+  {
+    return this->operator()(libIntegrate::execution::seq, x, y, ai, bi);
+  }
+
+  template<typename P, typename X, typename Y, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+  auto operator()( P policy, const X &x, const Y &y, long ai = 0, long bi = -1 ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),T())
   {
     using libIntegrate::getSize;
     using libIntegrate::getElement;
@@ -54,32 +129,19 @@ class SimpsonRule
     while( bi < 0 )
       bi += N;
 
-    long i;
-    for (i = ai; i < bi - 1; i += 2) {
-      // Integrate segment using three points
-      // \int_a^b f(x) dx = (b-a)/6 [ f(a) + 4*f(m) + f(b) ]
-      // a = x[i]
-      // b = x[i+2]
-      // m = (a+b)/2
-      //
-      // f(a) = y[i]
-      // f(b) = y[i+2]
-      // and we need to interpolate f(m)
-      // clang-format off
-      auto x1 = getElement(x,i);
-      auto x2 = getElement(x,i+1);
-      auto x3 = getElement(x,i+2);
-      auto y1 = getElement(y,i);
-      auto y2 = getElement(y,i+1);
-      auto y3 = getElement(y,i+2);
-      T m = (x1 + x3)/2;
-      T ym = y1*LagrangePolynomial(m, x2, x3, x1)
-           + y2*LagrangePolynomial(m, x1, x3, x2)
-           + y3*LagrangePolynomial(m, x1, x2, x3);
-
-      sum += (x3-x1)/6 * (y1 + 4*ym + y3);
-      // clang-format on
-    }
+    // the segments [x[ai+2k],x[ai+2k+2]] are summed in blocks of k, so
+    // every block starts on a segment boundary.
+    sum = libIntegrate::detail::blockedSum<Accumulator_>(policy, 0, (bi - ai) / 2, [&x, &y, ai](long kb, long ke) {
+      Accumulator_ s;
+      for (long i = ai + 2 * kb; i < ai + 2 * ke; i += 2) {
+        // Integrate segment using three points
+        // clang-format off
+        s.add(Segment(getElement(x,i), getElement(x,i+1), getElement(x,i+2),
+                      getElement(y,i), getElement(y,i+1), getElement(y,i+2)));
+        // clang-format on
+      }
+      return s;
+    }).value();
 
     // if the number of elements in the range that was integrated
     // is even, then there will be one element at the end that has not
@@ -89,24 +151,124 @@ class SimpsonRule
       // there is one extra point at the end we need to handle
       // we will use the last *three* points to fit the polynomial
       // but then integrate between the last *two* points.
-      i = bi-2;
-      auto x1 = getElement(x,i);
-      auto x2 = getElement(x,i+1);
-      auto x3 = getElement(x,i+2);
-      auto y1 = getElement(y,i);
-      auto y2 = getElement(y,i+1);
-      auto y3 = getElement(y,i+2);
-      T m = (x2 + x3)/2;
-      T ym = y1*LagrangePolynomial(m, x2, x3, x1)
-           + y2*LagrangePolynomial(m, x1, x3, x2)
-           + y3*LagrangePolynomial(m, x1, x2, x3);
-
-      sum += (x3-x2)/6 * (y2 + 4*ym + y3);
+      long i = bi-2;
+      // clang-format off
+      sum += EndInterval(getElement(x,i), getElement(x,i+1), getElement(x,i+2),
+                         getElement(y,i), getElement(y,i+1), getElement(y,i+2));
+      // clang-format on
     }
 
     return sum;
   }
 
+  /**
+   * Compute the cumulative integral of a discretized function in one pass.
+   * Element i of the returned vector is the integral from x[0] to x[i],
+   * i.e. the same as operator()(x,y,0,i). Element 1 is computed with the
+   * trapezoid rule, since there are not enough points to fit a quadratic
+   * (the same as Accumulator).
+   *
+   * Pass libIntegrate::execution::par as the first argument to compute the
+   * segment sums and the running sum in parallel.
+   */
+  template<typename X, typename Y>
+  auto cumulative( const X &x, const Y &y ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),std::vector<T>())
+  {
+    return cumulative(libIntegrate::execution::seq, x, y);
+  }
+
+  template<typename P, typename X, typename Y, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+  auto cumulative( P policy, const X &x, const Y &y ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),std::vector<T>())
+  {
+    using libIntegrate::getSize;
+    using libIntegrate::getElement;
+
+    long N = getSize(x);
+    std::vector<T> sum(N);
+    if(N < 2)
+      return sum;
+
+    // the running sum of the segments [x[0],x[2]], [x[2],x[4]], ... gives the
+    // even elements. odd elements are the previous even element plus the
+    // last interval.
+    // clang-format off
+    libIntegrate::detail::forEachIndex(policy, 1, (N+1)/2, [&](long k) {
+      long i = 2*k;
+      sum[i] = Segment(getElement(x,i-2), getElement(x,i-1), getElement(x,i),
+                       getElement(y,i-2), getElement(y,i-1), getElement(y,i));
+    });
+    libIntegrate::detail::inclusiveScan(policy, sum);
+    libIntegrate::detail::forEachIndex(policy, 1, N/2, [&](long k) {
+      long i = 2*k+1;
+      sum[i] += EndInterval(getElement(x,i-2), getElement(x,i-1), getElement(x,i),
+                            getElement(y,i-2), getElement(y,i-1), getElement(y,i));
+    });
+    sum[1] = (getElement(x,1) - getElement(x,0)) * (getElement(y,1) + getElement(y,0)) / 2;
+    // clang-format on
+
+    return sum;
+  }
+
+  /**
+   * Compute the weight of each point, so that sum_i w[i]*y[i] is the same
+   * as operator()(x,y,ai,bi) (up to rounding) for any y. The weights of the
+   * points outside of [ai,bi] are zero. See QuadraturePlan.
+   *
+   * The range must contain 3 or more points, like operator()(x,y,ai,bi).
+   */
+  template<typename X>
+  auto weights( const X &x, long ai = 0, long bi = -1 ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),std::vector<T>())
+  {
+    using libIntegrate::getSize;
+    using libIntegrate::getElement;
+
+    long N = getSize(x);
+    std::vector<T> w(N);
+    if(N == 0)
+      return w;
+
+    // support for negative indices.
+    // interpret -n to mean the N-n index
+    while( ai < 0 )
+      ai += N;
+    while( bi < 0 )
+      bi += N;
+
+    // the same segments as operator()(x,y,ai,bi)
+    auto add = [&w](long i, const std::array<T, 3> &s) {
+      for(long k = 0; k < 3; k++)
+        w[i+k] += s[k];
+    };
+    long i;
+    for(i = ai; i < ai + 2 * ((bi - ai) / 2); i += 2)
+      add(i, SegmentWeights(getElement(x,i), getElement(x,i+1), getElement(x,i+2)));
+    if( (bi+1-ai) % 2 == 0)
+    {
+      i = bi-2;
+      add(i, EndIntervalWeights(getElement(x,i), getElement(x,i+1), getElement(x,i+2)));
+    }
+
+    return w;
+  }
+
+  /**
+   * Integrate a batch of functions that share the argument values x, one
+   * function in each row (or column) of the 2D container f, and return
+   * the integrals. The same as QuadraturePlan<T,S>(*this,x).batch(f,layout),
+   * see QuadraturePlan::batch.
+   */
+  template<typename X, typename F>
+  auto batch( const X &x, const F &f, BatchLayout layout = BatchLayout::Rows ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getSizeX(f),std::vector<T>())
+  {
+    return batch(libIntegrate::execution::seq, x, f, layout);
+  }
+
+  template<typename P, typename X, typename F, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+  auto batch( P policy, const X &x, const F &f, BatchLayout layout = BatchLayout::Rows ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getSizeX(f),std::vector<T>())
+  {
+    return QuadraturePlan<T,S>(*this, x).batch(policy, f, layout);
+  }
+
   /**
    * This version will integrate a uniformly discretized function with y
    * values held in a container.
@@ -121,14 +283,26 @@ class SimpsonRule
   {
     using libIntegrate::getSize;
     using libIntegrate::getElement;
-    T sum = 0;
+    Accumulator_ s;
     decltype(getSize(y)) i;
 
-    for(i = 0; i < getSize(y)-2; i+=2)
+    if constexpr(libIntegrate::detail::isContiguousOf_v<T,Y>)
+    {
+      // the segments end at the last even index, m. Interior even points are
+      // shared by two segments, odd points are the segment mid points.
+      auto m = getSize(y) - 1 - (getSize(y)+1) % 2;
+      s = libIntegrate::detail::weightedSum<S>(std::data(y), m+1, T(2), T(4));
+      s.add(-getElement(y,0));
+      s.add(-getElement(y,m));
+    }
+    else
     {
-      sum += getElement(y,i) + 4*getElement(y,i+1) + getElement(y,i+2);
+      for(i = 0; i < getSize(y)-2; i+=2)
+      {
+        s.add(getElement(y,i) + 4*getElement(y,i+1) + getElement(y,i+2));
+      }
     }
-    sum *= dx/3.;
+    T sum = s.value()*(dx/3.);
 
     // if the container size is even, there will be one extra interval we need to handle
     if( getSize(y) % 2 == 0)
@@ -152,40 +326,108 @@ class SimpsonRule
 
 
  protected:
-  T LagrangePolynomial(T x, T A, T B, T C) const;
+  // sum the end points a and b, four times the mid points a+I*dx+dx/2 and twice
+  // the interior points a+(J+1)*dx, i.e. without the factor of dx/6.
+  template<typename F, std::size_t... I, std::size_t... J>
+  static constexpr T Unrolled(F &f, T a, T b, T dx, std::index_sequence<I...>, std::index_sequence<J...>)
+  {
+    Accumulator_ sum;
+    sum.add(f(a) + f(b));
+    (sum.add(4 * f(a + I * dx + dx / 2)), ...);
+    (sum.add(2 * f(a + (J + 1) * dx)), ...);
+    return sum.value();
+  }
+
+  // the same for N intervals at run time, with any integrand.
+  template<typename R, typename F>
+  static R CallableSum(F &f, T a, T b, T dx, std::size_t N)
+  {
+    libIntegrate::detail::IntegrandAccumulator<S, T, R> sum;
+    R y = f(a);
+    libIntegrate::detail::axpy(T(1), f(b), y);
+    sum.add(y);
+    for (std::size_t i = 0; i < N; i++) {
+      sum.add(T(4), f(a + i * dx + dx / 2));
+      if (i > 0) sum.add(T(2), f(a + i * dx));
+    }
+    return sum.value();
+  }
+
+  static T LagrangePolynomial(T x, T A, T B, T C);
+
+  // Integrate the segment [x1,x3] using three points
+  // \int_a^b f(x) dx = (b-a)/6 [ f(a) + 4*f(m) + f(b) ]
+  // where f(m) is interpolated at the midpoint m = (a+b)/2.
+  template<typename X, typename Y>
+  static T Segment(X x1, X x2, X x3, Y y1, Y y2, Y y3)
+  {
+    T m = (x1 + x3)/2;
+    T ym = y1*LagrangePolynomial(m, x2, x3, x1)
+         + y2*LagrangePolynomial(m, x1, x3, x2)
+         + y3*LagrangePolynomial(m, x1, x2, x3);
+
+    return (x3-x1)/6 * (y1 + 4*ym + y3);
+  }
+
+  // Integrate the last interval [x2,x3], using all *three* points to fit
+  // the polynomial.
+  template<typename X, typename Y>
+  static T EndInterval(X x1, X x2, X x3, Y y1, Y y2, Y y3)
+  {
+    T m = (x2 + x3)/2;
+    T ym = y1*LagrangePolynomial(m, x2, x3, x1)
+         + y2*LagrangePolynomial(m, x1, x3, x2)
+         + y3*LagrangePolynomial(m, x1, x2, x3);
+
+    return (x3-x2)/6 * (y2 + 4*ym + y3);
+  }
+
+  // The weights of y1, y2 and y3 in Segment(x1,x2,x3,y1,y2,y3).
+  static std::array<T, 3> SegmentWeights(T x1, T x2, T x3)
+  {
+    T m = (x1 + x3)/2;
+    T h = (x3-x1)/6;
+    return {h*(1 + 4*LagrangePolynomial(m, x2, x3, x1)),
+            h*4*LagrangePolynomial(m, x1, x3, x2),
+            h*(1 + 4*LagrangePolynomial(m, x1, x2, x3))};
+  }
+
+  // The weights of y1, y2 and y3 in EndInterval(x1,x2,x3,y1,y2,y3).
+  static std::array<T, 3> EndIntervalWeights(T x1, T x2, T x3)
+  {
+    T m = (x2 + x3)/2;
+    T h = (x3-x2)/6;
+    return {h*4*LagrangePolynomial(m, x2, x3, x1),
+            h*(1 + 4*LagrangePolynomial(m, x1, x3, x2)),
+            h*(1 + 4*LagrangePolynomial(m, x1, x2, x3))};
+  }
 };
 
-template<typename T, std::size_t NN>
+template<typename T, std::size_t NN, typename S>
 template<typename F, std::size_t NN_, typename SFINAE>
-T SimpsonRule<T, NN>::operator()(F f, T a, T b, std::size_t N) const
+libIntegrate::detail::IntegralOf<T, F, T> SimpsonRule<T, NN, S>::operator()(F f, T a, T b, std::size_t N) const
 {
-  T sum = 0;
+  using R = libIntegrate::detail::IntegralOf<T, F, T>;
   T dx  = static_cast<T>(b - a) / N;  // size of each interval
-  T x = a;
-  for (std::size_t i = 0; i < N; i++, x += dx) {
-    sum += f(x) + 4 * f(x + dx / 2) + f(x + dx);
-  }
   // note that 2*h = dx
-  sum *= dx / 6;
-  return sum;
+  return libIntegrate::detail::scaled(CallableSum<R>(f, a, b, dx, N), dx / 6);
 }
 
-template<typename T, std::size_t NN>
+template<typename T, std::size_t NN, typename S>
 template<typename F, std::size_t NN_, typename SFINAE>
-T SimpsonRule<T, NN>::operator()(F f, T a, T b) const
+constexpr libIntegrate::detail::IntegralOf<T, F, T> SimpsonRule<T, NN, S>::operator()(F f, T a, T b) const
 {
-  T sum = 0;
+  using R = libIntegrate::detail::IntegralOf<T, F, T>;
   T dx  = static_cast<T>(b - a) / NN;  // size of each interval
-  T x = a;
-  for (std::size_t i = 0; i < NN; i++, x += dx) {
-    sum += f(x) + 4 * f(x + dx / 2) + f(x + dx);
-  }
   // note that 2*h = dx
-  sum *= dx / 6;
-  return sum;
+  if constexpr (NN <= libIntegrate::detail::unrollLimit && !libIntegrate::detail::isVectorValue_v<T, R>) {
+    return Unrolled(f, a, b, dx, std::make_index_sequence<NN>{}, std::make_index_sequence<NN - 1>{}) * (dx / 6);
+  } else {
+    return libIntegrate::detail::scaled(CallableSum<R>(f, a, b, dx, NN), dx / 6);
+  }
 }
-template<typename T, std::size_t NN>
-T SimpsonRule<T, NN>::LagrangePolynomial(T x, T A, T B, T C) const
+template<typename T, std::size_t NN, typename S>
+T SimpsonRule<T, NN, S>::LagrangePolynomial(T x, T A, T B, T C)
 {
   return (x - A) * (x - B) / (C - A) / (C - B);
 }
@@ -1,31 +1,100 @@
 #pragma once
 #include<cstddef>
 #include<type_traits>
+#include<utility>
+#include<vector>
 
 #include "./Utils.hpp"
+#include "../Execution.hpp"
+#include "../Integrand.hpp"
+#include "../Simd.hpp"
+#include "../Summation.hpp"
+#include "./QuadraturePlan.hpp"
 
 namespace _1D {
 
 /** @class 
   * @brief A class that implements the trapezoid rule.
   * @author C.D. Clark III
+  *
+  * The terms are added with the summation policy S (see Summation.hpp).
   */
-template<typename T, std::size_t NN = 0>
+template<typename T, std::size_t NN = 0, typename S = libIntegrate::summation::Naive>
 class TrapezoidRule
 {
+    using Accumulator_ = libIntegrate::summation::Accumulator<S,T>;
+
   public:
     TrapezoidRule() = default;
 
-    // This version will integrate a callable between two points
+    /**
+     * Accumulates a trapezoid sum one point at a time, so that data can be
+     * integrated as it is read without storing it.
+     *
+     * value() returns the same result as integrating all of the points
+     * added so far with operator()(x,y) (up to rounding, operator()(x,y)
+     * sums contiguous arrays with several accumulators).
+     */
+    class Accumulator
+    {
+      public:
+        void add(T x, T y)
+        {
+          if(m_size > 0)
+            m_sum.add((y+m_y)*(x-m_x));
+          m_x = x;
+          m_y = y;
+          ++m_size;
+        }
+
+        T value() const { return 0.5*m_sum.value(); }
+        std::size_t size() const { return m_size; }
+
+      private:
+        Accumulator_ m_sum;
+        T m_x = 0;
+        T m_y = 0;
+        std::size_t m_size = 0;
+    };
+
+    // This version will integrate a callable between two points.
+    // f is evaluated once at each of the N+1 points, and it may return a
+    // vector of values (see Integrand.hpp), in which case each component is integrated.
     template<typename F, std::size_t NN_ = NN, typename SFINAE = typename std::enable_if<(NN_==0)>::type>
-    T operator()( F f, T a, T b, std::size_t N ) const;
+    libIntegrate::detail::IntegralOf<T,F,T> operator()( F f, T a, T b, std::size_t N ) const;
 
+    // For NN <= libIntegrate::detail::unrollLimit the sum is unrolled at compile time,
+    // and it is a constant expression if f is.
     template<typename F, std::size_t NN_ = NN, typename SFINAE = typename std::enable_if<(NN_>0)>::type>
-    T operator()( F f, T a, T b) const;
+    constexpr libIntegrate::detail::IntegralOf<T,F,T> operator()( F f, T a, T b) const;
 
-    // This version will integrate a set of discrete points
+    // Refine the estimate I of the integral of f over [a,b] with N intervals
+    // to the estimate with 2N intervals. Only the N new mid points are
+    // evaluated, so the refinements reuse every previous evaluation (see RombergRule).
+    template<typename F>
+    T refine( F f, T a, T b, std::size_t N, T I ) const
+    {
+      Accumulator_ sum;
+      T dx = static_cast<T>(b-a)/N;
+      for(std::size_t i = 0; i < N; ++i)
+        sum.add(f(a + i*dx + dx/2));
+      return I/2 + sum.value()*(dx/2);
+    }
+
+    // This version will integrate a set of discrete points.
+    //
+    // Pass libIntegrate::execution::par as the first argument to sum the
+    // intervals in parallel. The range is split into fixed-size blocks that
+    // do not depend on the number of threads, so the result is bitwise
+    // identical with either policy and any number of threads.
     template<typename X, typename Y>
     auto operator()( const X &x, const Y &y, long ai = 0, long bi = -1 ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),T())
+    {
+      return this->operator()(libIntegrate::execution::seq, x, y, ai, bi);
+    }
+
+    template<typename P, typename X, typename Y, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+    auto operator()( P policy, const X &x, const Y &y, long ai = 0, long bi = -1 ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),T())
     {
       using libIntegrate::getSize;
       using libIntegrate::getElement;
@@ -42,28 +111,160 @@ class TrapezoidRule
       while( bi < 0 )
         bi += N;
 
-      for(long i = ai; i < bi; i++)
-        sum += (getElement(y,i+1)+getElement(y,i))*(getElement(x,i+1)-getElement(x,i));
+      sum = libIntegrate::detail::blockedSum<Accumulator_>(policy, ai, bi, [&x,&y](long b, long e) { return Sum(x, y, b, e); }).value();
       sum *= 0.5;
 
       return sum;
     }
 
+    /*
+     * Compute the cumulative integral of a discretized function in one pass.
+     * Element i of the returned vector is the integral from x[0] to x[i],
+     * i.e. the same as operator()(x,y,0,i).
+     *
+     * Pass libIntegrate::execution::par as the first argument to compute the
+     * interval sums and the running sum in parallel.
+     */
+    template<typename X, typename Y>
+    auto cumulative( const X &x, const Y &y ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),std::vector<T>())
+    {
+      return cumulative(libIntegrate::execution::seq, x, y);
+    }
+
+    template<typename P, typename X, typename Y, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+    auto cumulative( P policy, const X &x, const Y &y ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getElement(y,0),std::vector<T>())
+    {
+      using libIntegrate::getSize;
+      using libIntegrate::getElement;
+
+      long N = getSize(x);
+      std::vector<T> sum(N);
+      libIntegrate::detail::forEachIndex(policy, 1, N, [&](long i) {
+        sum[i] = (getElement(y,i)+getElement(y,i-1))*(getElement(x,i)-getElement(x,i-1));
+      });
+      libIntegrate::detail::inclusiveScan(policy, sum);
+      libIntegrate::detail::forEachIndex(policy, 1, N, [&](long i) { sum[i] *= 0.5; });
+
+      return sum;
+    }
+
+    /*
+     * Compute the weight of each point, so that sum_i w[i]*y[i] is the same
+     * as operator()(x,y,ai,bi) (up to rounding) for any y. The weights of
+     * the points outside of [ai,bi] are zero. See QuadraturePlan.
+     */
+    template<typename X>
+    auto weights( const X &x, long ai = 0, long bi = -1 ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),std::vector<T>())
+    {
+      using libIntegrate::getSize;
+      using libIntegrate::getElement;
+
+      long N = getSize(x);
+      std::vector<T> w(N);
+      if(N == 0)
+        return w;
+
+      // support for negative indices.
+      // interpret -n to mean the N-n index
+      while( ai < 0 )
+        ai += N;
+      while( bi < 0 )
+        bi += N;
+
+      // each interval contributes half of its width to both of its end points.
+      for(long i = ai; i < bi; i++)
+      {
+        T h = (getElement(x,i+1) - getElement(x,i))/2;
+        w[i] += h;
+        w[i+1] += h;
+      }
+
+      return w;
+    }
+
+    /*
+     * Integrate a batch of functions that share the argument values x, one
+     * function in each row (or column) of the 2D container f, and return
+     * the integrals. The same as QuadraturePlan<T,S>(*this,x).batch(f,layout),
+     * see QuadraturePlan::batch.
+     */
+    template<typename X, typename F>
+    auto batch( const X &x, const F &f, BatchLayout layout = BatchLayout::Rows ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getSizeX(f),std::vector<T>())
+    {
+      return batch(libIntegrate::execution::seq, x, f, layout);
+    }
+
+    template<typename P, typename X, typename F, typename SFINAE = std::enable_if_t<libIntegrate::execution::is_execution_policy_v<P>>>
+    auto batch( P policy, const X &x, const F &f, BatchLayout layout = BatchLayout::Rows ) const -> decltype(libIntegrate::getSize(x),libIntegrate::getElement(x,0),libIntegrate::getSizeX(f),std::vector<T>())
+    {
+      return QuadraturePlan<T,S>(*this, x).batch(policy, f, layout);
+    }
+
     // This version will integrate a set of discrete points that are equally spaced
     template<typename Y>
     auto operator()( const Y &y, T dx = 1 ) const -> decltype(libIntegrate::getSize(y),dx*libIntegrate::getElement(y,0),T())
     {
       using libIntegrate::getSize;
       using libIntegrate::getElement;
-      T sum = 0;
-      for(decltype(getSize(y)) i = 0; i < getSize(y)-1; i++)
-        sum += (getElement(y,i+1)+getElement(y,i));
-      sum *= 0.5*dx;
+      Accumulator_ sum;
+      if constexpr(libIntegrate::detail::isContiguousOf_v<T,Y>)
+      {
+        // every point is counted twice, except the end points.
+        auto N = getSize(y);
+        if(N < 2)
+          return T(0);
+        sum = libIntegrate::detail::weightedSum<S>(std::data(y), N, T(2), T(2));
+        sum.add(-getElement(y,0));
+        sum.add(-getElement(y,N-1));
+      }
+      else
+      {
+        for(decltype(getSize(y)) i = 0; i < getSize(y)-1; i++)
+          sum.add(getElement(y,i+1)+getElement(y,i));
+      }
 
-      return sum;
+      return sum.value()*(0.5*dx);
     }
 
   protected:
+    // sum the end points a and b and twice the interior points a+(I+1)*dx, i.e. without the factor of 1/2.
+    template<typename F, std::size_t... I>
+    static constexpr T Unrolled( F &f, T a, T b, T dx, std::index_sequence<I...> )
+    {
+      Accumulator_ sum;
+      sum.add(f(a) + f(b));
+      (sum.add(2*f(a + (I+1)*dx)), ...);
+      return sum.value();
+    }
+
+    // the same for N intervals at run time, with any integrand.
+    template<typename R, typename F>
+    static R CallableSum( F &f, T a, T b, T dx, std::size_t N )
+    {
+      libIntegrate::detail::IntegrandAccumulator<S,T,R> sum;
+      R y = f(a);
+      libIntegrate::detail::axpy(T(1), f(b), y);
+      sum.add(y);
+      for(std::size_t i = 1; i < N; ++i)
+        sum.add(T(2), f(a + i*dx));
+      return sum.value();
+    }
+
+    // sum the intervals [x[i],x[i+1]] for i in [ai,bi), without the factor of 1/2.
+    template<typename X, typename Y>
+    static Accumulator_ Sum( const X &x, const Y &y, long ai, long bi )
+    {
+      using libIntegrate::getElement;
+
+      // contiguous float and double arrays use the vectorized kernel
+      if constexpr(libIntegrate::detail::isContiguousOf_v<T,X> && libIntegrate::detail::isContiguousOf_v<T,Y>)
+        return libIntegrate::detail::intervalSum<S,libIntegrate::detail::TrapezoidInterval>(std::data(x)+ai, std::data(y)+ai, bi-ai);
+
+      Accumulator_ sum;
+      for(long i = ai; i < bi; i++)
+        sum.add((getElement(y,i+1)+getElement(y,i))*(getElement(x,i+1)-getElement(x,i)));
+      return sum;
+    }
 };
 
 
@@ -73,34 +274,29 @@ class TrapezoidRule
  * @param b upper limit of integration.
  * @param N number of *sub-intervals* to divide the integral [a,b] into.
  **/
-template<typename T, std::size_t NN>
+template<typename T, std::size_t NN, typename S>
 template<typename F, std::size_t NN_, typename SFINAE>
-T TrapezoidRule<T,NN>::operator()( F f, T a, T b, std::size_t N ) const
+libIntegrate::detail::IntegralOf<T,F,T> TrapezoidRule<T,NN,S>::operator()( F f, T a, T b, std::size_t N ) const
 {
-  T sum = 0;
+  using R = libIntegrate::detail::IntegralOf<T,F,T>;
   T dx = static_cast<T>(b-a)/N; // NOTE: N is the number of sub-intervals here
-  T x = a;
-  for(std::size_t i = 0; i < N; ++i, x += dx)
-  {
-    sum += f(x) + f(x + dx);
-  }
-  sum *= 0.5*dx;
-  return sum;
+  return libIntegrate::detail::scaled(CallableSum<R>(f, a, b, dx, N), 0.5*dx);
 }
 
-template<typename T, std::size_t NN>
+template<typename T, std::size_t NN, typename S>
 template<typename F, std::size_t NN_, typename SFINAE>
-T TrapezoidRule<T,NN>::operator()( F f, T a, T b ) const
+constexpr libIntegrate::detail::IntegralOf<T,F,T> TrapezoidRule<T,NN,S>::operator()( F f, T a, T b ) const
 {
-  T sum = 0;
+  using R = libIntegrate::detail::IntegralOf<T,F,T>;
   T dx = static_cast<T>(b-a)/NN; // NOTE: N is the number of sub-intervals here
-  T x = a;
-  for(std::size_t i = 0; i < NN; ++i, x += dx)
+  if constexpr(NN <= libIntegrate::detail::unrollLimit && !libIntegrate::detail::isVectorValue_v<T,R>)
+  {
+    return Unrolled(f, a, b, dx, std::make_index_sequence<NN-1>{})*(0.5*dx);
+  }
+  else
   {
-    sum += f(x) + f(x + dx);
+    return libIntegrate::detail::scaled(CallableSum<R>(f, a, b, dx, NN), 0.5*dx);
   }
-  sum *= 0.5*dx;
-  return sum;
 }
 
 }
@@ -0,0 +1,27 @@
+#pragma once
+
+#include<cstddef>
+#include "./DiscretizedIntegratorWrapper.hpp"
+#include "../_1D/CubicSplineRule.hpp"
+
+namespace _2D {
+
+/** @class 
+  * @brief A class that integrates a tensor-product natural cubic spline through a 2D discretized function exactly.
+  *
+  * The spline integral is a linear function of the data, so integrating each row with
+  * _1D::CubicSplineRule and then integrating the row integrals the same way gives the
+  * integral of the bicubic spline surface.
+  */
+template<typename T, typename S = libIntegrate::summation::Naive>
+class CubicSplineRule : public DiscretizedIntegratorWrapper<_1D::CubicSplineRule<T,0,S>>
+{ 
+  public:
+
+    using BaseType = DiscretizedIntegratorWrapper<_1D::CubicSplineRule<T,0,S>>;
+    using BaseType::operator();
+};
+
+
+
+}
@@ -3,6 +3,8 @@
 #include<vector>
 
 #include "./Utils.hpp"
+#include "../Integrand.hpp"
+#include "../_1D/Utils.hpp"
 #include "../_1D/RandomAccessLambda.hpp"
 #include "../_2D/RandomAccessLambda.hpp"
 
@@ -11,6 +13,9 @@ namespace _2D {
 /** @class 
   * @brief A class that does 2D integration on discretized functions using various rules.
   * @author C.D. Clark III
+  *
+  * Both directions are integrated with the 1D integrator, so the sums are
+  * added with its summation policy (see Summation.hpp).
   */
 template<typename Integrator>
 class DiscretizedIntegratorWrapper
@@ -25,6 +30,9 @@ class DiscretizedIntegratorWrapper
   template<template<typename,std::size_t> class V, typename T, std::size_t N>
   struct getDataType<V<T,N>> {using type = T;};
 
+  template<template<typename,std::size_t,typename> class V, typename T, std::size_t N, typename S>
+  struct getDataType<V<T,N,S>> {using type = T;};
+
   using DataType = typename getDataType<Integrator>::type;
 
   public:
@@ -53,23 +61,38 @@ class DiscretizedIntegratorWrapper
       std::vector<DataType> sums(getSizeX(f));
       for(std::size_t i = 0; i < sums.size(); ++i)
       {
-        sums[i] = integrate(  _1D::RandomAccessLambda( [&f,i](std::size_t j){return f[i][j];}, [&f](){return libIntegrate::getSizeY(f);}), dy);
+        sums[i] = integrate(  _1D::RandomAccessLambda( [&f,i](std::size_t j){return getElement(f,i,j);}, [&f](){return libIntegrate::getSizeY(f);}), dy);
       }
       return integrate(sums,dx);
     }
 
+    // f may return a vector of values (see Integrand.hpp). It is evaluated
+    // once at each point of the grid, and each component is integrated.
     template<typename F>
-    DataType operator()( F f, DataType xa, DataType xb, std::size_t xN, DataType ya, DataType yb, std::size_t yN ) const
+    auto operator()( F f, DataType xa, DataType xb, std::size_t xN, DataType ya, DataType yb, std::size_t yN ) const -> libIntegrate::detail::IntegralOf<DataType,F,DataType,DataType>
     {
+      using R = libIntegrate::detail::IntegralOf<DataType,F,DataType,DataType>;
       // discretize the function with lambda functions
       // and call the discretized function integrators
       DataType dx = (xb-xa)/xN;
       DataType dy = (yb-ya)/yN;
-      return this->operator()(
-          _1D::RandomAccessLambda([&xa,&dx](int i){return xa + i*dx;},[&xN](){return xN+1;}),
-          _1D::RandomAccessLambda([&ya,&dy](int j){return ya + j*dy;},[&yN](){return yN+1;}),
-          [&xa,&ya,&dx,&dy,&f](int i, int j){ return f(xa+i*dx,ya+j*dy); }
-      );
+      auto X = _1D::RandomAccessLambda([&xa,&dx](int i){return xa + i*dx;},[&xN](){return xN+1;});
+      auto Y = _1D::RandomAccessLambda([&ya,&dy](int j){return ya + j*dy;},[&yN](){return yN+1;});
+      if constexpr(libIntegrate::detail::isVectorValue_v<DataType,R>)
+      {
+        std::vector<R> values;
+        values.reserve((xN+1)*(yN+1));
+        for(std::size_t i = 0; i <= xN; i++)
+          for(std::size_t j = 0; j <= yN; j++)
+            values.push_back(f(xa+i*dx,ya+j*dy));
+        return libIntegrate::detail::integrateComponents(values, [&](auto v) {
+          return this->operator()(X, Y, [&v,&yN](int i, int j){ return v(i*(yN+1)+j); });
+        });
+      }
+      else
+      {
+        return this->operator()(X, Y, [&xa,&ya,&dx,&dy,&f](int i, int j){ return f(xa+i*dx,ya+j*dy); });
+      }
     }
 
   protected:
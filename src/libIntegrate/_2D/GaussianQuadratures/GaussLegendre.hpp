@@ -8,31 +8,36 @@
 
 #include<cstddef>
 #include<array>
+#include "../../Integrand.hpp"
 #include "../../_1D/GaussianQuadratures/GaussLegendre.hpp"
 
 namespace _2D {
 namespace GQ {
 
-template<typename T, std::size_t Order>
+// the inner and outer sums are added with the summation policy S (see Summation.hpp).
+template<typename T, std::size_t Order, typename S = libIntegrate::summation::Naive>
 class GaussLegendreQuadrature
 {
   public:
-    _1D::GQ::GaussLegendreQuadrature<T,Order> _1dInt;
+    _1D::GQ::GaussLegendreQuadrature<T,Order,S> _1dInt;
 
     GaussLegendreQuadrature() = default;
 
-    // This version will integrate a callable between four points
+    // This version will integrate a callable between four points.
+    // f may return a vector of values (see Integrand.hpp), and each component is integrated.
     template<typename F, typename X, typename Y>
-    T operator()( F f, X a, X b, Y c, Y d ) const;
+    libIntegrate::detail::IntegralOf<T,F,X,Y> operator()( F f, X a, X b, Y c, Y d ) const;
 
   protected:
 };
 
 
-template<typename T, std::size_t Order>
+template<typename T, std::size_t Order, typename S>
 template<typename F, typename X, typename Y>
-T GaussLegendreQuadrature<T,Order>::operator()(F f, X a, X b, Y c, Y d) const
+libIntegrate::detail::IntegralOf<T,F,X,Y> GaussLegendreQuadrature<T,Order,S>::operator()(F f, X a, X b, Y c, Y d) const
 {
+  using R = libIntegrate::detail::IntegralOf<T,F,X,Y>;
+
   // A 2D integral I = \int \int f(x,y) dx dy
   // can be written as two 1D integrals
   //
@@ -43,19 +48,18 @@ T GaussLegendreQuadrature<T,Order>::operator()(F f, X a, X b, Y c, Y d) const
 
   X apb = (b + a)/2;
   X amb = (b - a)/2;
-  std::array<T, Order> sums;
+  std::array<R, Order> sums;
 
   #pragma omp parallel for
   for(std::size_t i = 0; i < Order; i++)
     sums[i] = _1dInt( [&](Y y){ return f(apb + amb*_1dInt.getX()[i], y); }, c, d );
 
   // now integrate over x
-  T sum = 0;
+  libIntegrate::detail::IntegrandAccumulator<S,T,R> sum;
   for(std::size_t i = 0; i < Order; i++)
-    sum += _1dInt.getW()[i]*sums[i];
-  sum *= amb;
+    sum.add(_1dInt.getW()[i], sums[i]);
 
-  return sum;
+  return libIntegrate::detail::scaled(sum.value(), amb);
 }
 
 }
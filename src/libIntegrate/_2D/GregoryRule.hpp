@@ -0,0 +1,26 @@
+#pragma once
+
+#include<cstddef>
+#include "./DiscretizedIntegratorWrapper.hpp"
+#include "../_1D/GregoryRule.hpp"
+
+namespace _2D {
+
+/** @class 
+  * @brief A class that implements the trapezoid rule with Gregory end corrections in 2D.
+  *
+  * Each direction is integrated with _1D::GregoryRule, so the grid must be
+  * equally spaced (at least near the edges) in both directions.
+  */
+template<typename T, typename S = libIntegrate::summation::Naive>
+class GregoryRule : public DiscretizedIntegratorWrapper<_1D::GregoryRule<T,0,S>>
+{ 
+  public:
+
+    using BaseType = DiscretizedIntegratorWrapper<_1D::GregoryRule<T,0,S>>;
+    using BaseType::operator();
+};
+
+
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/** @file Grid.hpp
+ * @brief A contiguous 2D container for discretized functions.
+ */
+
+namespace _2D
+{
+/**
+ * A row-major 2D grid of values stored in a single contiguous allocation.
+ *
+ * Element (i,j) is stored at data()[i*cols() + j]. Elements can be accessed with
+ * z(i,j), or with z[i][j] like a nested vector (operator[] returns a pointer to
+ * the start of row i), so it can be used anywhere a std::vector<std::vector<T>>
+ * was used, and with libIntegrate::getElement(z,i,j), getSizeX(z) and getSizeY(z).
+ */
+template<typename T>
+class Grid
+{
+ public:
+  Grid() = default;
+  Grid(std::size_t rows, std::size_t cols, const T& value = T()) : m_rows(rows), m_cols(cols), m_data(rows * cols, value) {}
+
+  // resizes the grid to rows x cols and sets all elements to value.
+  void assign(std::size_t rows, std::size_t cols, const T& value = T())
+  {
+    m_rows = rows;
+    m_cols = cols;
+    m_data.assign(rows * cols, value);
+  }
+
+  T&       operator()(std::size_t i, std::size_t j) { return m_data[i * m_cols + j]; }
+  const T& operator()(std::size_t i, std::size_t j) const { return m_data[i * m_cols + j]; }
+
+  T*       operator[](std::size_t i) { return m_data.data() + i * m_cols; }
+  const T* operator[](std::size_t i) const { return m_data.data() + i * m_cols; }
+
+  std::size_t rows() const { return m_rows; }
+  std::size_t cols() const { return m_cols; }
+  bool        empty() const { return m_data.empty(); }
+
+  T*       data() { return m_data.data(); }
+  const T* data() const { return m_data.data(); }
+
+  // element (i,j) is data()[i*rowStride() + j*colStride()].
+  std::ptrdiff_t rowStride() const { return m_cols; }
+  std::ptrdiff_t colStride() const { return 1; }
+
+ private:
+  std::size_t    m_rows = 0;
+  std::size_t    m_cols = 0;
+  std::vector<T> m_data;
+};
+
+}  // namespace _2D
@@ -10,12 +10,12 @@ namespace _2D {
   * @brief A class that implements Riemann sums.
   * @author C.D. Clark III
   */
-template<typename T>
-class RiemannRule : public DiscretizedIntegratorWrapper<_1D::RiemannRule<T>>
+template<typename T, typename S = libIntegrate::summation::Naive>
+class RiemannRule : public DiscretizedIntegratorWrapper<_1D::RiemannRule<T,0,S>>
 { 
   public:
 
-    using BaseType = DiscretizedIntegratorWrapper<_1D::RiemannRule<T>>;
+    using BaseType = DiscretizedIntegratorWrapper<_1D::RiemannRule<T,0,S>>;
     using BaseType::operator();
 
 
@@ -10,12 +10,12 @@ namespace _2D {
   * @brief A class that implements Simpson sums.
   * @author C.D. Clark III
   */
-template<typename T>
-class SimpsonRule : public DiscretizedIntegratorWrapper<_1D::SimpsonRule<T>>
+template<typename T, typename S = libIntegrate::summation::Naive>
+class SimpsonRule : public DiscretizedIntegratorWrapper<_1D::SimpsonRule<T,0,S>>
 { 
   public:
 
-    using BaseType = DiscretizedIntegratorWrapper<_1D::SimpsonRule<T>>;
+    using BaseType = DiscretizedIntegratorWrapper<_1D::SimpsonRule<T,0,S>>;
     using BaseType::operator();
 };
 
@@ -10,12 +10,12 @@ namespace _2D {
   * @brief A class that implements Trapezoid sums.
   * @author C.D. Clark III
   */
-template<typename T>
-class TrapezoidRule : public DiscretizedIntegratorWrapper<_1D::TrapezoidRule<T>>
+template<typename T, typename S = libIntegrate::summation::Naive>
+class TrapezoidRule : public DiscretizedIntegratorWrapper<_1D::TrapezoidRule<T,0,S>>
 { 
   public:
 
-    using BaseType = DiscretizedIntegratorWrapper<_1D::TrapezoidRule<T>>;
+    using BaseType = DiscretizedIntegratorWrapper<_1D::TrapezoidRule<T,0,S>>;
     using BaseType::operator();
 };
 
@@ -0,0 +1,185 @@
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <libIntegrate/Compression.hpp>
+#include <libIntegrate/IO.hpp>
+
+#if defined(LIBINTEGRATE_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(LIBINTEGRATE_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace CompressionTests
+{
+// returns the data in small pieces to exercise the read-ahead buffering
+class StringDecompressor : public libIntegrate::Decompressor
+{
+ public:
+  StringDecompressor(std::string data, std::size_t piece, std::size_t failAt = std::string::npos) : m_data(std::move(data)), m_piece(piece), m_failAt(failAt) {}
+  std::size_t read(char* buffer, std::size_t n) override
+  {
+    if(m_pos >= m_failAt) throw std::runtime_error("Corrupt test data.");
+    n = std::min({n, m_piece, m_data.size() - m_pos});
+    std::copy(m_data.begin() + m_pos, m_data.begin() + m_pos + n, buffer);
+    m_pos += n;
+    return n;
+  }
+
+ private:
+  std::string m_data;
+  std::size_t m_piece;
+  std::size_t m_failAt;
+  std::size_t m_pos = 0;
+};
+
+std::string makeData(int N)
+{
+  std::ostringstream out;
+  out.precision(17);
+  for(int i = 0; i < N; ++i) {
+    if(i % 100 == 0) out << "# block\n\n";
+    out << i * 0.01 << " " << std::sin(i * 0.01) << "\n";
+  }
+  return out.str();
+}
+
+void checkSame(const std::vector<libIntegrate::gnuplot::DataPoint>& data, const std::vector<libIntegrate::gnuplot::DataPoint>& expected)
+{
+  REQUIRE(data.size() == expected.size());
+  for(std::size_t i = 0; i < data.size(); ++i) {
+    CHECK(data[i].x == expected[i].x);
+    CHECK(data[i].y == expected[i].y);
+  }
+}
+
+TEST_CASE("Read-ahead stream buffer", "[compression]")
+{
+  const std::string text = makeData(5000);
+  auto              expected = libIntegrate::gnuplot::readGnuplotData(text.data(), text.data() + text.size());
+
+  SECTION("Reading in small blocks")
+  {
+    libIntegrate::ReadAheadStreamBuf buf(std::make_unique<StringDecompressor>(text, 777), 1000, 2);
+    std::istream                     in(&buf);
+
+    std::vector<libIntegrate::gnuplot::DataPoint> data;
+    libIntegrate::gnuplot::forEachDataPoint(in, [&data](const libIntegrate::gnuplot::DataPoint& p) { data.push_back(p); });
+    checkSame(data, expected);
+    CHECK_NOTHROW(buf.throwIfError());
+  }
+
+  SECTION("Errors end the stream and are rethrown")
+  {
+    libIntegrate::ReadAheadStreamBuf buf(std::make_unique<StringDecompressor>(text, 100, 5000), 1000, 2);
+    std::istream                     in(&buf);
+    std::string                      all(std::istreambuf_iterator<char>(in), {});
+    CHECK(all.size() == 5000);
+    CHECK_THROWS_AS(buf.throwIfError(), std::runtime_error);
+  }
+
+  SECTION("Destroying the buffer before reading everything")
+  {
+    libIntegrate::ReadAheadStreamBuf buf(std::make_unique<StringDecompressor>(text, 100), 100, 2);
+    std::istream                     in(&buf);
+    std::string                      line;
+    std::getline(in, line);
+    CHECK(line == "# block");
+  }
+}
+
+TEST_CASE("Reading compressed files", "[compression]")
+{
+  const std::string text     = makeData(20000);
+  auto              expected = libIntegrate::gnuplot::readGnuplotData(text.data(), text.data() + text.size());
+
+  SECTION("Uncompressed files are read directly")
+  {
+    const std::string filename = "test_function_data-uncompressed.txt";
+    std::ofstream(filename) << text;
+    CHECK(libIntegrate::detectCompression(filename) == libIntegrate::Compression::None);
+    libIntegrate::InputFile in(filename);
+    CHECK(in.compression() == libIntegrate::Compression::None);
+    checkSame(libIntegrate::gnuplot::readGnuplotData(in), expected);
+    CHECK_THROWS(libIntegrate::InputFile("missing-file.txt"));
+    std::remove(filename.c_str());
+  }
+
+#if defined(LIBINTEGRATE_HAVE_ZLIB)
+  SECTION("gzip")
+  {
+    const std::string filename = "test_function_data.txt.gz";
+    // two concatenated members, like pigz or `cat a.gz b.gz` produce
+    for(int member = 0; member < 2; ++member) {
+      gzFile out = gzopen(filename.c_str(), member == 0 ? "wb" : "ab");
+      REQUIRE(out != nullptr);
+      std::size_t half = text.size() / 2;
+      std::string part = member == 0 ? text.substr(0, half) : text.substr(half);
+      gzwrite(out, part.data(), static_cast<unsigned>(part.size()));
+      gzclose(out);
+    }
+    CHECK(libIntegrate::detectCompression(filename) == libIntegrate::Compression::Gzip);
+
+    checkSame(libIntegrate::gnuplot::readGnuplotData(filename), expected);
+    checkSame(libIntegrate::gnuplot::readGnuplotDataMapped(filename), expected);
+    checkSame(libIntegrate::gnuplot::readGnuplotDataParallel(filename), expected);
+    auto columns = libIntegrate::gnuplot::readGnuplotColumns(filename);
+    REQUIRE(columns.size() == expected.size());
+    CHECK(columns.y().back() == expected.back().y.value());
+    CHECK(libIntegrate::gnuplot::readTable(filename).rows() == expected.size());
+
+    SECTION("Truncated files throw")
+    {
+      std::ifstream     in(filename, std::ios::binary);
+      std::string       compressed(std::istreambuf_iterator<char>(in), {});
+      const std::string truncated = "test_function_data-truncated.txt.gz";
+      std::ofstream(truncated, std::ios::binary) << compressed.substr(0, compressed.size() / 3);
+      CHECK_THROWS_AS(libIntegrate::gnuplot::readGnuplotColumns(truncated), std::runtime_error);
+      std::remove(truncated.c_str());
+    }
+    std::remove(filename.c_str());
+  }
+#endif
+
+#if defined(LIBINTEGRATE_HAVE_ZSTD)
+  SECTION("zstd")
+  {
+    const std::string filename = "test_function_data.txt.zst";
+    auto              compress = [](const std::string& data) {
+      std::string compressed(ZSTD_compressBound(data.size()), '\0');
+      std::size_t size = ZSTD_compress(compressed.data(), compressed.size(), data.data(), data.size(), 3);
+      REQUIRE(!ZSTD_isError(size));
+      compressed.resize(size);
+      return compressed;
+    };
+    std::string compressed = compress(text);
+    std::size_t size       = compressed.size();
+    std::ofstream(filename, std::ios::binary) << compressed;
+    CHECK(libIntegrate::detectCompression(filename) == libIntegrate::Compression::Zstd);
+
+    checkSame(libIntegrate::gnuplot::readGnuplotData(filename), expected);
+    checkSame(libIntegrate::gnuplot::readGnuplotDataMapped(filename), expected);
+    checkSame(libIntegrate::gnuplot::readGnuplotDataParallel(filename), expected);
+    CHECK(libIntegrate::gnuplot::readTable(filename).rows() == expected.size());
+
+    // a file with two frames, as written by concatenating .zst files
+    std::size_t half = text.size() / 2;
+    std::ofstream(filename, std::ios::binary) << compress(text.substr(0, half)) + compress(text.substr(half));
+    checkSame(libIntegrate::gnuplot::readGnuplotData(filename), expected);
+
+    const std::string truncated = "test_function_data-truncated.txt.zst";
+    std::ofstream(truncated, std::ios::binary) << compressed.substr(0, size / 2);
+    CHECK_THROWS_AS(libIntegrate::gnuplot::readGnuplotColumns(truncated), std::runtime_error);
+    std::remove(truncated.c_str());
+    std::remove(filename.c_str());
+  }
+#endif
+}
+
+}  // namespace CompressionTests
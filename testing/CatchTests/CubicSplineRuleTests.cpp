@@ -0,0 +1,178 @@
+#include <cmath>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <libIntegrate/_1D/CubicSplineRule.hpp>
+#include <libIntegrate/_1D/TrapezoidRule.hpp>
+#include <libIntegrate/_2D/CubicSplineRule.hpp>
+#include <libIntegrate/_2D/Grid.hpp>
+#include <libIntegrate/_2D/TrapezoidRule.hpp>
+using namespace Catch;
+
+namespace CubicSplineRuleTests
+{
+TEST_CASE("Cubic spline rule on linear functions.")
+{
+  _1D::CubicSplineRule<double> integrate;
+  double                       I;
+
+  I = integrate([](double x) { return 2 * x + 3; }, 2., 5., 3);
+  CHECK(I == Approx(5 * 5 + 5 * 3 - 2 * 2 - 2 * 3));
+
+  std::vector<double> x = {0, 0.5, 2, 2.1, 4}, y(5);
+  for(std::size_t i = 0; i < x.size(); i++) y[i] = 2 * x[i] + 3;
+  CHECK(integrate(x, y) == Approx(4 * 4 + 3 * 4));
+
+  // not enough points for a spline, it is a line
+  x.resize(2);
+  y.resize(2);
+  CHECK(integrate(x, y) == Approx(0.5 * 0.5 + 3 * 0.5));
+}
+
+TEST_CASE("Cubic spline rule on discretized functions.")
+{
+  _1D::CubicSplineRule<double> integrate;
+
+  SECTION("Three points")
+  {
+    // the natural spline through (0,0), (1,1), (2,0) has M_1 = -3,
+    // so each segment is 1/2 + 3/24
+    std::vector<double> x = {0, 1, 2}, y = {0, 1, 0};
+    CHECK(integrate(x, y) == Approx(1.25));
+    CHECK(integrate(x, y, 0, 1) == Approx(0.625));
+    CHECK(integrate(x, y, 1, 2) == Approx(0.625));
+    CHECK(integrate(y, 1.) == Approx(1.25));
+  }
+
+  SECTION("Non-uniform grid")
+  {
+    // sin has zero second derivative at 0 and pi, so the natural spline is a good fit.
+    std::size_t         N = 51;
+    std::vector<double> x(N), y(N);
+    for(std::size_t i = 0; i < N; i++) {
+      x[i] = M_PI * (i + 0.3 * std::sin(1. * i)) / (N - 1);
+      y[i] = std::sin(x[i]);
+    }
+    x.back() = M_PI;
+    y.back() = 0;
+
+    _1D::TrapezoidRule<double> trap;
+    double                     I = integrate(x, y);
+    CHECK(I == Approx(2).epsilon(1e-6));
+    CHECK(std::abs(I - 2) < std::abs(trap(x, y) - 2) / 100);
+
+    // the spline is fit to all of the points, so sub-ranges add up to the whole range.
+    CHECK(integrate(x, y, 0, 20) + integrate(x, y, 20, -1) == Approx(I));
+    CHECK(integrate(x, y, 0, 0) == 0);
+  }
+
+  SECTION("Uniform grid")
+  {
+    std::size_t         N  = 101;
+    double              dx = M_PI / (N - 1);
+    std::vector<double> x(N), y(N);
+    for(std::size_t i = 0; i < N; i++) {
+      x[i] = i * dx;
+      y[i] = std::sin(x[i]);
+    }
+    CHECK(integrate(y, dx) == Approx(integrate(x, y)));
+    CHECK(integrate(y, dx) == Approx(2).epsilon(1e-8));
+    CHECK(integrate([](double x) { return std::sin(x); }, 0, M_PI, N - 1) == Approx(2).epsilon(1e-8));
+  }
+}
+
+TEST_CASE("Cubic spline rule cumulative integral matches discretized integration.")
+{
+  _1D::CubicSplineRule<double> integrate;
+
+  std::vector<double> x, y;
+  for(int i = 0; i < 21; i++) {
+    x.push_back(i * i * 0.01);
+    y.push_back(std::sin(x.back()));
+  }
+
+  auto I = integrate.cumulative(x, y);
+  REQUIRE(I.size() == x.size());
+  CHECK(I[0] == 0);
+  for(long n = 1; n < (long)x.size(); n++) {
+    CHECK(I[n] == Approx(integrate(x, y, 0, n)));
+  }
+
+  auto Ip = integrate.cumulative(libIntegrate::execution::par, x, y);
+  for(std::size_t n = 0; n < x.size(); n++) {
+    CHECK(Ip[n] == Approx(I[n]));
+  }
+}
+
+TEST_CASE("2D Cubic Spline Rule")
+{
+  _2D::CubicSplineRule<double> integrate;
+
+  SECTION("Integrating a callable")
+  {
+    auto f = [](double x, double y) { return std::sin(x) * std::sin(y); };
+    CHECK(integrate(f, 0, M_PI, 100, 0, M_PI, 100) == Approx(4).epsilon(1e-8));
+  }
+
+  SECTION("Bilinear function on a non-uniform grid")
+  {
+    // the spline through a bilinear function is the function itself.
+    std::vector<double> x = {0, 0.5, 2, 2.1, 4}, y = {1, 1.2, 3};
+    _2D::Grid<double>   f(x.size(), y.size());
+    for(std::size_t i = 0; i < x.size(); i++)
+      for(std::size_t j = 0; j < y.size(); j++) f(i, j) = 1 + x[i] + 2 * x[i] * y[j];
+    // \int_0^4 \int_1^3 1 + x + 2xy dy dx = 8 + 16 + 64
+    CHECK(integrate(x, y, f) == Approx(88));
+  }
+
+  SECTION("Coarse grid")
+  {
+    // sin has zero second derivative at 0 and pi, so a grid with 4 times fewer points
+    // in each direction is still more accurate than the trapezoid rule.
+    auto grid = [](std::size_t n, std::vector<double> &x, _2D::Grid<double> &f) {
+      x.resize(n);
+      for(std::size_t i = 0; i < n; i++) x[i] = i * M_PI / (n - 1);
+      f = _2D::Grid<double>(n, n);
+      for(std::size_t i = 0; i < n; i++)
+        for(std::size_t j = 0; j < n; j++) f(i, j) = std::sin(x[i]) * std::sin(x[j]);
+    };
+
+    std::vector<double>        x, xf;
+    _2D::Grid<double>          f, ff;
+    _2D::TrapezoidRule<double> trap;
+    grid(26, x, f);
+    grid(101, xf, ff);
+
+    double I = integrate(x, x, f);
+    CHECK(I == Approx(4).epsilon(1e-5));
+    CHECK(std::abs(I - 4) < std::abs(trap(xf, xf, ff) - 4));
+    CHECK(integrate(f, x[1] - x[0], x[1] - x[0]) == Approx(I));
+  }
+}
+
+TEST_CASE("Cubic spline rule benchmarks", "[.][benchmarks]")
+{
+  std::size_t         N = 1 << 20;
+  std::vector<double> x(N), y(N);
+  for(std::size_t i = 0; i < N; i++) {
+    x[i] = 10. * i / (N - 1);
+    y[i] = std::sin(x[i]);
+  }
+
+  _1D::CubicSplineRule<double> integrate;
+  _1D::TrapezoidRule<double>   trap;
+
+  BENCHMARK("1M points, trapezoid rule")
+  {
+    return trap(x, y);
+  };
+
+  BENCHMARK("1M points, cubic spline rule")
+  {
+    return integrate(x, y);
+  };
+}
+
+}  // namespace CubicSplineRuleTests
@@ -0,0 +1,98 @@
+#include <cmath>
+#include <vector>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <libIntegrate/_1D/GregoryRule.hpp>
+#include <libIntegrate/_1D/TrapezoidRule.hpp>
+#include <libIntegrate/_2D/Grid.hpp>
+#include <libIntegrate/_2D/GregoryRule.hpp>
+#include <libIntegrate/_2D/TrapezoidRule.hpp>
+using namespace Catch;
+
+namespace GregoryRuleTests
+{
+TEST_CASE("Gregory rule on polynomials.")
+{
+  _1D::GregoryRule<double> integrate;
+
+  // the corrections make the rule exact for cubics.
+  CHECK(integrate([](double x) { return 2 * x + 3; }, 2., 5., 3) == Approx(5 * 5 + 5 * 3 - 2 * 2 - 2 * 3));
+  CHECK(integrate([](double x) { return x * x; }, 0., 3., 6) == Approx(9));
+  CHECK(integrate([](double x) { return x * x * x; }, 0., 2., 10) == Approx(4));
+  CHECK(integrate([](double x) { return x * x * x; }, 0., 2., 2) == Approx(4));
+
+  // not enough points for the corrections, it is the trapezoid rule
+  CHECK(integrate([](double x) { return x * x; }, 0., 1., 1) == Approx(0.5));
+}
+
+TEST_CASE("Gregory rule on discretized functions.")
+{
+  _1D::GregoryRule<double>   integrate;
+  _1D::TrapezoidRule<double> trap;
+
+  std::size_t         N  = 41;
+  double              dx = M_PI / (N - 1);
+  std::vector<double> x(N), y(N);
+  for(std::size_t i = 0; i < N; i++) {
+    x[i] = i * dx;
+    y[i] = std::sin(x[i]);
+  }
+
+  double I = integrate(x, y);
+  CHECK(I == Approx(2).epsilon(1e-5));
+  CHECK(std::abs(I - 2) < std::abs(trap(x, y) - 2) / 100);
+  CHECK(integrate(y, dx) == Approx(I));
+  CHECK(integrate([](double x) { return std::sin(x); }, 0, M_PI, N - 1) == Approx(I));
+
+  // sub-ranges are corrected at their own end points
+  CHECK(integrate(x, y, 0, 20) == Approx(1).epsilon(1e-5));
+  CHECK(integrate(x, y, 20, -1) == Approx(1).epsilon(1e-5));
+  CHECK(integrate(x, y, 0, 0) == 0);
+
+  // doubling the number of points reduces the error by ~16
+  std::size_t         N2  = 2 * N - 1;
+  double              dx2 = M_PI / (N2 - 1);
+  std::vector<double> y2(N2);
+  for(std::size_t i = 0; i < N2; i++) y2[i] = std::sin(i * dx2);
+  double ratio = std::abs(I - 2) / std::abs(integrate(y2, dx2) - 2);
+  CHECK(ratio > 12);
+  CHECK(ratio < 20);
+}
+
+TEST_CASE("2D Gregory Rule")
+{
+  _2D::GregoryRule<double>   integrate;
+  _2D::TrapezoidRule<double> trap;
+
+  SECTION("Integrating a callable")
+  {
+    auto f = [](double x, double y) { return std::sin(x) * std::sin(y); };
+    CHECK(integrate(f, 0, M_PI / 2, 100, 0, M_PI / 2, 100) == Approx(1).epsilon(1e-8));
+  }
+
+  SECTION("Discretized function on a grid")
+  {
+    // a grid with 4 times fewer points in each direction is still more accurate than the trapezoid rule.
+    auto grid = [](std::size_t n, std::vector<double> &x, std::vector<double> &y, _2D::Grid<double> &f) {
+      x.resize(n);
+      y.resize(n);
+      for(std::size_t i = 0; i < n; i++) x[i] = y[i] = i * (M_PI / 2) / (n - 1);
+      f = _2D::Grid<double>(n, n);
+      for(std::size_t i = 0; i < n; i++)
+        for(std::size_t j = 0; j < n; j++) f(i, j) = std::sin(x[i]) * std::sin(y[j]);
+    };
+
+    std::vector<double> x, y, xf, yf;
+    _2D::Grid<double>   f, ff;
+    grid(26, x, y, f);
+    grid(101, xf, yf, ff);
+
+    double I = integrate(x, y, f);
+    CHECK(I == Approx(1).epsilon(1e-5));
+    CHECK(std::abs(I - 1) < std::abs(trap(xf, yf, ff) - 1));
+    CHECK(integrate(f, x[1] - x[0], y[1] - y[0]) == Approx(I));
+  }
+}
+
+}  // namespace GregoryRuleTests
@@ -0,0 +1,132 @@
+#include <cmath>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <libIntegrate/IO.hpp>
+#include <libIntegrate/_2D/Grid.hpp>
+#include <libIntegrate/_2D/RiemannRule.hpp>
+#include <libIntegrate/_2D/SimpsonRule.hpp>
+#include <libIntegrate/_2D/TrapezoidRule.hpp>
+using namespace Catch;
+
+TEST_CASE("Contiguous 2D grid")
+{
+  _2D::Grid<double> z(3, 4);
+  REQUIRE(z.rows() == 3);
+  REQUIRE(z.cols() == 4);
+  CHECK(!z.empty());
+  CHECK(libIntegrate::getSizeX(z) == 3);
+  CHECK(libIntegrate::getSizeY(z) == 4);
+
+  for(std::size_t i = 0; i < z.rows(); ++i)
+    for(std::size_t j = 0; j < z.cols(); ++j) z(i, j) = 10 * i + j;
+
+  // row-major and contiguous
+  CHECK(z.data()[0] == 0);
+  CHECK(z.data()[5] == 11);
+  CHECK(z[2][3] == 23);
+  CHECK(&z[1][0] == z.data() + 4);
+  CHECK(libIntegrate::getElement(z, 2, 1) == 21);
+
+  z.assign(2, 2, 1.5);
+  CHECK(z.rows() == 2);
+  CHECK(z.cols() == 2);
+  CHECK(z(1, 1) == 1.5);
+
+  CHECK(_2D::Grid<double>().empty());
+}
+
+TEST_CASE("Integrating a contiguous 2D grid")
+{
+  std::size_t Nx = 101, Ny = 51;
+  double      dx = (M_PI / 2) / (Nx - 1);
+  double      dy = (M_PI / 2) / (Ny - 1);
+
+  std::vector<double>              x(Nx), y(Ny);
+  std::vector<std::vector<double>> nested(Nx, std::vector<double>(Ny));
+  _2D::Grid<double>                grid(Nx, Ny);
+  for(std::size_t i = 0; i < Nx; i++) x[i] = i * dx;
+  for(std::size_t j = 0; j < Ny; j++) y[j] = j * dy;
+  for(std::size_t i = 0; i < Nx; i++) {
+    for(std::size_t j = 0; j < Ny; j++) {
+      nested[i][j] = grid(i, j) = sin(x[i]) * sin(y[j]);
+    }
+  }
+
+  SECTION("Riemann")
+  {
+    _2D::RiemannRule<double> integrate;
+    CHECK(integrate(x, y, grid) == integrate(x, y, nested));
+    CHECK(integrate(grid, dx, dy) == integrate(nested, dx, dy));
+  }
+  SECTION("Trapezoid")
+  {
+    _2D::TrapezoidRule<double> integrate;
+    CHECK(integrate(x, y, grid) == integrate(x, y, nested));
+    CHECK(integrate(grid, dx, dy) == integrate(nested, dx, dy));
+    CHECK(integrate(x, y, grid) == Approx(1).epsilon(0.001));
+  }
+  SECTION("Simpson")
+  {
+    _2D::SimpsonRule<double> integrate;
+    CHECK(integrate(x, y, grid) == integrate(x, y, nested));
+    CHECK(integrate(grid, dx, dy) == integrate(nested, dx, dy));
+    CHECK(integrate(x, y, grid) == Approx(1).epsilon(0.0001));
+  }
+}
+
+TEST_CASE("2D grid benchmarks", "[.][benchmarks]")
+{
+  std::size_t N  = 1000;
+  double      dx = M_PI / (N - 1);
+
+  std::vector<double>                      x(N), y(N);
+  std::vector<libIntegrate::gnuplot::DataPoint> points;
+  for(std::size_t i = 0; i < N; i++) x[i] = y[i] = i * dx;
+  for(std::size_t i = 0; i < N; i++)
+    for(std::size_t j = 0; j < N; j++) points.push_back({x[i], y[j], sin(x[i]) * sin(y[j])});
+
+  std::vector<double>              ex, ey;
+  std::vector<std::vector<double>> nested;
+  _2D::Grid<double>                grid;
+  libIntegrate::gnuplot::extract(points, ex, ey, nested);
+  libIntegrate::gnuplot::extract(points, ex, ey, grid);
+
+  BENCHMARK("extract into nested vectors")
+  {
+    std::vector<std::vector<double>> z;
+    libIntegrate::gnuplot::extract(points, ex, ey, z);
+    return z.size();
+  };
+
+  BENCHMARK("extract into contiguous grid")
+  {
+    _2D::Grid<double> z;
+    libIntegrate::gnuplot::extract(points, ex, ey, z);
+    return z.rows();
+  };
+
+  _2D::TrapezoidRule<double> integrate;
+
+  BENCHMARK("trapezoid rule, nested vectors")
+  {
+    return integrate(x, y, nested);
+  };
+
+  BENCHMARK("trapezoid rule, contiguous grid")
+  {
+    return integrate(x, y, grid);
+  };
+
+  BENCHMARK("uniform trapezoid rule, nested vectors")
+  {
+    return integrate(nested, dx, dx);
+  };
+
+  BENCHMARK("uniform trapezoid rule, contiguous grid")
+  {
+    return integrate(grid, dx, dx);
+  };
+}
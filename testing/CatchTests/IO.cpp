@@ -1,11 +1,17 @@
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <fstream>
 #include <string>
 #include <vector>
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <libIntegrate/IO.hpp>
+#include <libIntegrate/_1D/TrapezoidRule.hpp>
+#include <libIntegrate/_2D/TrapezoidRule.hpp>
 
 using namespace Catch;
 
@@ -255,3 +261,682 @@ TEST_CASE("load and extract gnuplot data")
     CHECK(z[2][1] == Approx(60));
   }
 }
+
+TEST_CASE("Memory-mapped gnuplot data reader")
+{
+  using namespace libIntegrate::gnuplot;
+
+  SECTION("Matches the stream parser")
+  {
+    const std::string test_data =
+        "# header\n"
+        "\n"
+        "   # indented comment\n"
+        "1.5\n"
+        "\t2.5 3e2\r\n"
+        "+4 -5 .25\n"
+        "1 2 3 4\n"
+        "6 7 # trailing comment\n"
+        "8 nine 10\n"
+        "inf 1\n"
+        "11";
+
+    std::stringstream in(test_data);
+    auto              expected = readGnuplotData(in);
+    auto              data     = readGnuplotData(test_data.data(), test_data.data() + test_data.size());
+
+    REQUIRE(data.size() == expected.size());
+    REQUIRE(data.size() == 7);
+    for(size_t i = 0; i < data.size(); ++i) {
+      CHECK(data[i].x == expected[i].x);
+      CHECK(data[i].y == expected[i].y);
+      CHECK(data[i].z == expected[i].z);
+    }
+
+    CHECK(data[0].x.value() == 0);
+    CHECK(data[0].y.value() == 1.5);
+    CHECK(data[1].y.value() == 300);
+    CHECK(data[2].x.value() == 4);
+    CHECK(data[2].z.value() == 0.25);
+    CHECK(!data[3].x.has_value());
+    CHECK(data[4].y.value() == 7);
+    // parsing stops at the first non-numeric token
+    CHECK(data[5].x.value() == 1);
+    CHECK(data[5].y.value() == 8);
+    CHECK(data[6].x.value() == 2);
+    CHECK(data[6].y.value() == 11);
+  }
+
+  SECTION("Reading a file")
+  {
+    const std::string filename = "test_function_data-mapped.txt";
+    {
+      std::ofstream out(filename);
+      for(int i = 0; i < 100; ++i) {
+        double x = i * 0.1;
+        for(int j = 0; j < 10; ++j) {
+          double y = j * 0.1;
+          out << x << " " << y << " " << std::sin(x) * std::sin(y) << "\n";
+        }
+        out << "\n";
+      }
+    }
+
+    auto expected = readGnuplotData(filename);
+    auto data     = readGnuplotDataMapped(filename);
+
+    REQUIRE(data.size() == 1000);
+    REQUIRE(data.size() == expected.size());
+    for(size_t i = 0; i < data.size(); ++i) {
+      CHECK(data[i].x == expected[i].x);
+      CHECK(data[i].y == expected[i].y);
+      CHECK(data[i].z == expected[i].z);
+    }
+  }
+
+  SECTION("Empty and missing files")
+  {
+    const std::string filename = "test_function_data-empty.txt";
+    {
+      std::ofstream out(filename);
+    }
+    CHECK(readGnuplotDataMapped(filename).empty());
+    CHECK_THROWS(readGnuplotDataMapped("missing-file.txt"));
+  }
+}
+
+TEST_CASE("Streaming gnuplot data reader")
+{
+  using namespace libIntegrate::gnuplot;
+
+  // enough data to span several of the reader's internal blocks
+  std::stringstream text;
+  for(int i = 0; i < 20000; ++i) {
+    if(i % 100 == 0) text << "# block " << i / 100 << "\n\n";
+    text << i * 0.1 << " " << std::sin(i * 0.1) << "\n";
+  }
+  text << "1.5";  // no newline on the last line
+
+  auto expected = readGnuplotData(text);
+  text.clear();
+  text.seekg(0);
+
+  std::vector<DataPoint> data;
+  forEachDataPoint(text, [&data](const DataPoint& p) { data.push_back(p); });
+
+  REQUIRE(data.size() == 20001);
+  REQUIRE(data.size() == expected.size());
+  for(size_t i = 0; i < data.size(); ++i) {
+    CHECK(data[i].x == expected[i].x);
+    CHECK(data[i].y == expected[i].y);
+    CHECK(data[i].z == expected[i].z);
+  }
+  CHECK(data.back().x.value() == 0);
+  CHECK(data.back().y.value() == 1.5);
+}
+
+TEST_CASE("Columnar gnuplot data")
+{
+  using namespace libIntegrate::gnuplot;
+
+  SECTION("1D")
+  {
+    const std::string test_data = R"(# x y
+0.0 1
+0.1 2
+1 2 3 4
+0.2 1
+0.3 3
+)";
+
+    auto data = readGnuplotColumns(test_data.data(), test_data.data() + test_data.size());
+    std::stringstream in(test_data);
+    auto              streamed = readGnuplotColumns(in);
+
+    REQUIRE(data.size() == 4);
+    REQUIRE(streamed.size() == 4);
+    CHECK(data.hasAllXY());
+    CHECK(data.z().empty());
+    CHECK(data.x() == std::vector<double>{0.0, 0.1, 0.2, 0.3});
+    CHECK(data.y() == std::vector<double>{1, 2, 1, 3});
+    CHECK(streamed.x() == data.x());
+    CHECK(streamed.y() == data.y());
+    CHECK(!data.hasZ(0));
+    CHECK(!data[0].z.has_value());
+    CHECK(data[3].y.value() == 3);
+  }
+
+  SECTION("Missing values")
+  {
+    ColumnarData data;
+    data.push_back({1.0, 10.0, {}});
+    data.push_back({{}, 30.0, {}});
+    data.push_back({5.0, 50.0, 7.0});
+
+    REQUIRE(data.size() == 3);
+    CHECK(!data.hasAllXY());
+    CHECK(!data.hasX(1));
+    CHECK(data.hasY(1));
+    CHECK(std::isnan(data.x()[1]));
+    REQUIRE(data.z().size() == 3);
+    CHECK(std::isnan(data.z()[0]));
+    CHECK(data.z()[2] == 7.0);
+    CHECK(data.hasZ(2));
+    CHECK(!data.hasZ(0));
+
+    std::vector<double> x, y;
+    extract(data, x, y);
+    CHECK(x == std::vector<double>{1.0, 5.0});
+    CHECK(y == std::vector<double>{10.0, 50.0});
+  }
+
+  SECTION("2D")
+  {
+    const std::string test_data = R"(# x y
+0.1 3 10
+0.1 4 20
+
+0.2 3 30
+0.2 4 40
+)";
+
+    auto data = readGnuplotColumns(test_data.data(), test_data.data() + test_data.size());
+    REQUIRE(data.size() == 4);
+    CHECK(data.z() == std::vector<double>{10, 20, 30, 40});
+
+    std::vector<double>              x, y;
+    std::vector<std::vector<double>> z;
+    extract(data, x, y, z);
+    REQUIRE(x.size() == 2);
+    REQUIRE(y.size() == 2);
+    CHECK(z[0][0] == 10);
+    CHECK(z[0][1] == 20);
+    CHECK(z[1][0] == 30);
+    CHECK(z[1][1] == 40);
+  }
+}
+
+TEST_CASE("Parallel gnuplot data reader")
+{
+  using namespace libIntegrate::gnuplot;
+
+  // mix single, two, and three column lines so that implicit x values must be renumbered across chunks
+  std::string test_data = "# header\n";
+  for(int i = 0; i < 500; ++i) {
+    if(i % 50 == 0) test_data += "\n# block\n";
+    if(i % 3 == 0)
+      test_data += std::to_string(i * 0.5) + "\n";
+    else if(i % 3 == 1)
+      test_data += std::to_string(i * 0.1) + " " + std::to_string(i * 0.5) + "\n";
+    else
+      test_data += std::to_string(i * 0.1) + " " + std::to_string(i * 0.2) + " " + std::to_string(i * 0.5) + "\n";
+    if(i % 97 == 0) test_data += "1 2 3 4\n";
+  }
+  test_data += "1.5";  // no newline on the last line
+  const char* begin = test_data.data();
+  const char* end   = begin + test_data.size();
+
+  auto expected        = readGnuplotData(begin, end);
+  auto expectedColumns = readGnuplotColumns(begin, end);
+  REQUIRE(expected.back().x.value() == 167);
+
+  for(std::size_t chunkSize : {1, 7, 64, 1000, 1 << 20}) {
+    for(int threads : {1, 2, 4}) {
+      auto data = readGnuplotDataParallel(begin, end, threads, chunkSize);
+      REQUIRE(data.size() == expected.size());
+      for(size_t i = 0; i < data.size(); ++i) {
+        CHECK(data[i].x == expected[i].x);
+        CHECK(data[i].y == expected[i].y);
+        CHECK(data[i].z == expected[i].z);
+      }
+
+      auto columns = readGnuplotColumnsParallel(begin, end, threads, chunkSize);
+      REQUIRE(columns.size() == expectedColumns.size());
+      CHECK(columns.hasAllXY());
+      CHECK(columns.x() == expectedColumns.x());
+      CHECK(columns.y() == expectedColumns.y());
+      REQUIRE(columns.z().size() == expectedColumns.z().size());
+      for(size_t i = 0; i < columns.size(); ++i) {
+        CHECK(columns.hasZ(i) == expectedColumns.hasZ(i));
+        if(columns.hasZ(i)) CHECK(columns.z()[i] == expectedColumns.z()[i]);
+      }
+    }
+  }
+
+  SECTION("Empty input")
+  {
+    const std::string empty = "# nothing here\n\n";
+    CHECK(readGnuplotDataParallel(empty.data(), empty.data() + empty.size(), 2, 4).empty());
+    CHECK(readGnuplotColumnsParallel(empty.data(), empty.data() + empty.size(), 2, 4).empty());
+    CHECK(readGnuplotColumnsParallel(empty.data(), empty.data(), 2, 4).empty());
+  }
+}
+
+TEST_CASE("Multi-column tables")
+{
+  using namespace libIntegrate::gnuplot;
+
+  auto read = [](const std::string& text) { return readTable(text.data(), text.data() + text.size()); };
+
+  SECTION("gnuplot style")
+  {
+    auto table = read("# t ch1 ch2 ch3 ch4\n0 1 2 3 4\n\n1 5 6 7 8\n2 9 10\n");
+    REQUIRE(table.cols() == 5);
+    REQUIRE(table.rows() == 3);
+    CHECK(table.names().empty());
+    CHECK(table.column(0) == std::vector<double>{0, 1, 2});
+    CHECK(table.column(4)[1] == 8);
+    // short rows are padded with NaN
+    CHECK(std::isnan(table.column(3)[2]));
+    CHECK(std::isnan(table.column(4)[2]));
+  }
+
+  SECTION("CSV with header")
+  {
+    auto table = read("time, \"v1\",v2 ,v3\r\n0.0,1,2,3\r\n0.5, 4 ,,6\r\n1.0,7,8,nope\r\n");
+    REQUIRE(table.cols() == 4);
+    REQUIRE(table.rows() == 3);
+    CHECK(table.names() == std::vector<std::string>{"time", "v1", "v2", "v3"});
+    CHECK(table.find("v2") == 2);
+    CHECK(table.find("missing") == table.cols());
+    CHECK(table.column(0) == std::vector<double>{0, 0.5, 1});
+    CHECK(table.column(1) == std::vector<double>{1, 4, 7});
+    CHECK(std::isnan(table.column(2)[1]));
+    CHECK(std::isnan(table.column(3)[2]));
+  }
+
+  SECTION("TSV with header")
+  {
+    auto table = read("x\ty1\ty2\n1\t2\t3\n4\t5\t6");
+    REQUIRE(table.cols() == 3);
+    REQUIRE(table.rows() == 2);
+    CHECK(table.names() == std::vector<std::string>{"x", "y1", "y2"});
+    CHECK(table.column(2) == std::vector<double>{3, 6});
+
+    std::stringstream in("x\ty1\ty2\n1\t2\t3\n4\t5\t6");
+    auto              streamed = readTable(in);
+    CHECK(streamed.names() == table.names());
+    CHECK(streamed.column(1) == table.column(1));
+  }
+
+  SECTION("Integrating the columns")
+  {
+    std::string text = "x";
+    for(int j = 0; j < 50; ++j) text += " y" + std::to_string(j);
+    text += "\n";
+    for(int i = 0; i <= 100; ++i) {
+      text += std::to_string(i * 0.01);
+      for(int j = 0; j < 50; ++j) text += " " + std::to_string(j * i * 0.01);
+      text += "\n";
+    }
+    auto table = read(text);
+    REQUIRE(table.cols() == 51);
+    REQUIRE(table.rows() == 101);
+
+    _1D::TrapezoidRule<double> integrate;
+    for(std::size_t j = 1; j < table.cols(); ++j) {
+      CHECK(integrate(table.column(0), table.column(j)) == Approx((j - 1) * 0.5));
+    }
+  }
+
+  SECTION("Empty")
+  {
+    CHECK(read("# nothing\n\n").cols() == 0);
+    auto table = read("a,b\n");
+    CHECK(table.cols() == 2);
+    CHECK(table.empty());
+  }
+}
+
+TEST_CASE("Grid reconstruction")
+{
+  using namespace libIntegrate::gnuplot;
+
+  std::vector<double> xs = {0.1, 0.2, 0.3};
+  std::vector<double> ys = {3, 4};
+  auto                f  = [](double x, double y) { return 10 * x + y; };
+
+  auto check = [&](const std::vector<DataPoint>& data, GridReconstruction expected) {
+    std::vector<double>              x, y;
+    std::vector<std::vector<double>> z;
+    CHECK(extract(data, x, y, z) == expected);
+
+    REQUIRE(x == xs);
+    REQUIRE(y == ys);
+    REQUIRE(z.size() == 3);
+    for(size_t i = 0; i < x.size(); ++i) {
+      REQUIRE(z[i].size() == 2);
+      for(size_t j = 0; j < y.size(); ++j) {
+        CHECK(z[i][j] == f(x[i], y[j]));
+      }
+    }
+
+    // the columnar overload should take the same path
+    ColumnarData columns;
+    for(auto& p : data) columns.push_back(p);
+    std::vector<double>              cx, cy;
+    std::vector<std::vector<double>> cz;
+    CHECK(extract(columns, cx, cy, cz) == expected);
+    CHECK(cx == x);
+    CHECK(cy == y);
+    CHECK(cz == z);
+
+    // and so should extracting into a contiguous grid
+    for(int k = 0; k < 2; ++k) {
+      std::vector<double> gx, gy;
+      _2D::Grid<double>   gz;
+      CHECK((k == 0 ? extract(data, gx, gy, gz) : extract(columns, gx, gy, gz)) == expected);
+      CHECK(gx == x);
+      CHECK(gy == y);
+      REQUIRE(gz.rows() == 3);
+      REQUIRE(gz.cols() == 2);
+      for(size_t i = 0; i < x.size(); ++i) {
+        for(size_t j = 0; j < y.size(); ++j) {
+          CHECK(gz(i, j) == z[i][j]);
+        }
+      }
+    }
+  };
+
+  SECTION("x blocks")
+  {
+    std::vector<DataPoint> data;
+    for(double x : xs)
+      for(double y : ys) data.push_back({x, y, f(x, y)});
+    check(data, GridReconstruction::XBlocks);
+  }
+
+  SECTION("y blocks")
+  {
+    std::vector<DataPoint> data;
+    for(double y : ys)
+      for(double x : xs) data.push_back({x, y, f(x, y)});
+    check(data, GridReconstruction::YBlocks);
+  }
+
+  SECTION("decreasing coordinates")
+  {
+    std::vector<DataPoint> data;
+    for(auto x = xs.rbegin(); x != xs.rend(); ++x)
+      for(auto y = ys.rbegin(); y != ys.rend(); ++y) data.push_back({*x, *y, f(*x, *y)});
+    check(data, GridReconstruction::XBlocks);
+
+    data.clear();
+    for(auto y = ys.rbegin(); y != ys.rend(); ++y)
+      for(double x : xs) data.push_back({x, *y, f(x, *y)});
+    check(data, GridReconstruction::YBlocks);
+  }
+
+  SECTION("incomplete points are skipped")
+  {
+    std::vector<DataPoint> data;
+    for(double x : xs) {
+      for(double y : ys) data.push_back({x, y, f(x, y)});
+      data.push_back({x, 5., {}});
+    }
+    check(data, GridReconstruction::XBlocks);
+  }
+
+  SECTION("scattered points")
+  {
+    std::vector<DataPoint> data;
+    data.push_back({0.2, 4., f(0.2, 4)});
+    data.push_back({0.1, 3., f(0.1, 3)});
+    data.push_back({0.3, 4., f(0.3, 4)});
+    data.push_back({0.1, 4., f(0.1, 4)});
+    data.push_back({0.3, 3., f(0.3, 3)});
+    data.push_back({0.2, 3., f(0.2, 3)});
+    check(data, GridReconstruction::Sorted);
+  }
+
+  SECTION("irregular blocks")
+  {
+    // same blocks, but the second block is missing a point and it is added at the end
+    std::vector<DataPoint> data;
+    data.push_back({0.1, 3., f(0.1, 3)});
+    data.push_back({0.1, 4., f(0.1, 4)});
+    data.push_back({0.2, 3., f(0.2, 3)});
+    data.push_back({0.3, 3., f(0.3, 3)});
+    data.push_back({0.3, 4., f(0.3, 4)});
+    data.push_back({0.2, 4., f(0.2, 4)});
+    check(data, GridReconstruction::Sorted);
+  }
+}
+
+TEST_CASE("Binary data files")
+{
+  using namespace libIntegrate::binary;
+
+  std::vector<double> x(101), y(101);
+  for(size_t i = 0; i < x.size(); ++i) {
+    x[i] = i * M_PI / 100;
+    y[i] = std::sin(x[i]);
+  }
+  _1D::TrapezoidRule<double> integrate;
+
+  for(auto format : {Format::Npy, Format::Raw}) {
+    const std::string filename = format == Format::Npy ? "test_function_data-1d.npy" : "test_function_data-1d.f64";
+    writeColumns(filename, format, x, y);
+    CHECK(detectFormat(filename) == format);
+
+    auto a = read(filename);
+    REQUIRE(a.rows() == 101);
+    REQUIRE(a.cols() == 2);
+    CHECK(a(10, 0) == x[10]);
+    CHECK(a(10, 1) == y[10]);
+
+    // the views are passed straight to the integrators
+    auto X = a.column(0);
+    auto Y = a.column(1);
+    CHECK(X.stride() == 2);
+    CHECK(integrate(X, Y) == Approx(integrate(x, y)));
+    CHECK(integrate(X, Y) == Approx(2).epsilon(0.001));
+  }
+
+  SECTION("Text files")
+  {
+    const std::string filename = "test_function_data-1d-text.txt";
+    {
+      std::ofstream out(filename);
+      out << "0 1\n";
+    }
+    CHECK(detectFormat(filename) == Format::Text);
+    CHECK_THROWS(read(filename));
+  }
+
+  SECTION("Fortran ordered and 1D npy files")
+  {
+    auto writeHeader = [](std::ostream& out, const std::string& dict) {
+      std::string header = dict;
+      header.append((64 - (10 + header.size() + 1) % 64) % 64, ' ');
+      header += '\n';
+      out.write("\x93NUMPY\x01\x00", 8);
+      out.put(static_cast<char>(header.size() % 256));
+      out.put(static_cast<char>(header.size() / 256));
+      out << header;
+    };
+
+    {
+      std::ofstream out("test_function_data-fortran.npy", std::ios::binary);
+      writeHeader(out, "{'descr': '<f8', 'fortran_order': True, 'shape': (101, 2), }");
+      out.write(reinterpret_cast<const char*>(x.data()), x.size() * sizeof(double));
+      out.write(reinterpret_cast<const char*>(y.data()), y.size() * sizeof(double));
+    }
+    auto a = readNpy("test_function_data-fortran.npy");
+    CHECK(a.fortranOrder());
+    REQUIRE(a.rows() == 101);
+    REQUIRE(a.cols() == 2);
+    CHECK(a.column(1).stride() == 1);
+    CHECK(a(50, 0) == x[50]);
+    CHECK(a(50, 1) == y[50]);
+    CHECK(integrate(a.column(0), a.column(1)) == Approx(integrate(x, y)));
+
+    {
+      std::ofstream out("test_function_data-single_column.npy", std::ios::binary);
+      writeHeader(out, "{'descr': '<f8', 'fortran_order': False, 'shape': (101,), }");
+      out.write(reinterpret_cast<const char*>(y.data()), y.size() * sizeof(double));
+    }
+    auto b = readNpy("test_function_data-single_column.npy");
+    REQUIRE(b.rows() == 101);
+    REQUIRE(b.cols() == 1);
+    CHECK(integrate(b.column(0), M_PI / 100) == Approx(integrate(y, M_PI / 100)));
+
+    {
+      std::ofstream out("test_function_data-float32.npy", std::ios::binary);
+      writeHeader(out, "{'descr': '<f4', 'fortran_order': False, 'shape': (1,), }");
+      out.write("\0\0\0\0", 4);
+    }
+    CHECK_THROWS(readNpy("test_function_data-float32.npy"));
+
+    // only plain float64 arrays are read, not structured dtypes that contain a float64 field
+    for(std::string descr : {"[('a', '<f8'), ('b', '<i4')]", "'>f8'", "'<f8x'", "'<i8'"}) {
+      {
+        std::ofstream out("test_function_data-descr.npy", std::ios::binary);
+        writeHeader(out, "{'descr': " + descr + ", 'fortran_order': False, 'shape': (4,), }");
+        out.write(reinterpret_cast<const char*>(y.data()), 6 * sizeof(double));
+      }
+      INFO(descr);
+      CHECK_THROWS_AS(readNpy("test_function_data-descr.npy"), std::runtime_error);
+    }
+    {
+      std::ofstream out("test_function_data-descr.npy", std::ios::binary);
+      writeHeader(out, "{\"descr\": \"=f8\", \"fortran_order\": False, \"shape\": (4,)}");
+      out.write(reinterpret_cast<const char*>(y.data()), 4 * sizeof(double));
+    }
+    CHECK(readNpy("test_function_data-descr.npy")(3, 0) == y[3]);
+    std::remove("test_function_data-descr.npy");
+  }
+
+  SECTION("Shapes that overflow")
+  {
+    auto writeRawHeader = [&y](const std::string& filename, std::uint64_t rows, std::uint64_t cols) {
+      std::ofstream out(filename, std::ios::binary);
+      out.write("LIBINTF8", 8);
+      for(std::uint64_t n : {rows, cols})
+        for(int b = 0; b < 8; ++b) out.put(static_cast<char>(n >> (8 * b)));
+      out.write(reinterpret_cast<const char*>(y.data()), y.size() * sizeof(double));
+    };
+    // rows * cols wraps around to 0
+    writeRawHeader("test_function_data-overflow.f64", std::uint64_t(1) << 33, std::uint64_t(1) << 31);
+    CHECK_THROWS_AS(readRaw("test_function_data-overflow.f64"), std::runtime_error);
+    // the number of bytes wraps around
+    writeRawHeader("test_function_data-overflow.f64", std::uint64_t(1) << 61, 2);
+    CHECK_THROWS_AS(readRaw("test_function_data-overflow.f64"), std::runtime_error);
+    writeRawHeader("test_function_data-overflow.f64", 0, std::uint64_t(-1));
+    CHECK(readRaw("test_function_data-overflow.f64").rows() == 0);
+    std::remove("test_function_data-overflow.f64");
+  }
+
+  SECTION("2D")
+  {
+    std::vector<double>              gx(50), gy(60);
+    std::vector<std::vector<double>> gz(gx.size(), std::vector<double>(gy.size()));
+    for(size_t i = 0; i < gx.size(); ++i) gx[i] = i * (M_PI / 2) / (gx.size() - 1);
+    for(size_t j = 0; j < gy.size(); ++j) gy[j] = j * (M_PI / 2) / (gy.size() - 1);
+    for(size_t i = 0; i < gx.size(); ++i)
+      for(size_t j = 0; j < gy.size(); ++j) gz[i][j] = std::sin(gx[i]) * std::sin(gy[j]);
+
+    _2D::TrapezoidRule<double> integrate2d;
+    for(auto format : {Format::Npy, Format::Raw}) {
+      const std::string filename = format == Format::Npy ? "test_function_data-2d.npy" : "test_function_data-2d.f64";
+      writeGrid(filename, format, gx, gy, gz);
+
+      auto a = read(filename);
+      auto m = nonuniformMatrix(a);
+      REQUIRE(m.x.size() == gx.size());
+      REQUIRE(m.y.size() == gy.size());
+      REQUIRE(m.z.rows() == gx.size());
+      REQUIRE(m.z.cols() == gy.size());
+      CHECK(m.z(3, 4) == gz[3][4]);
+      CHECK(integrate2d(m.x, m.y, m.z) == Approx(integrate2d(gx, gy, gz)));
+      CHECK(integrate2d(m.x, m.y, m.z) == Approx(1).epsilon(0.001));
+    }
+  }
+}
+
+TEST_CASE("Gnuplot reader benchmarks", "[.][benchmarks]")
+{
+  const std::string filename = "test_function_data-benchmark.txt";
+  {
+    std::ofstream out(filename);
+    out.precision(17);
+    for(int i = 0; i < 200000; ++i) {
+      double x = i * 1e-3;
+      out << x << " " << std::sin(x) << "\n";
+    }
+  }
+
+  BENCHMARK("stream parser")
+  {
+    return libIntegrate::gnuplot::readGnuplotData(filename).size();
+  };
+
+  BENCHMARK("memory-mapped from_chars parser")
+  {
+    return libIntegrate::gnuplot::readGnuplotDataMapped(filename).size();
+  };
+
+  BENCHMARK("memory-mapped from_chars parser, columnar storage")
+  {
+    return libIntegrate::gnuplot::readGnuplotColumns(filename).size();
+  };
+
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("Parallel gnuplot reader benchmarks", "[.][benchmarks]")
+{
+  const std::string filename = "test_function_data-parallel-benchmark.txt";
+  {
+    std::ofstream out(filename);
+    out.precision(17);
+    for(int i = 0; i < 2000000; ++i) {
+      double x = i * 1e-4;
+      out << x << " " << std::sin(x) << "\n";
+    }
+  }
+  libIntegrate::MappedFile file(filename);
+
+  BENCHMARK("serial parser, columnar storage")
+  {
+    return libIntegrate::gnuplot::readGnuplotColumns(file.begin(), file.end()).size();
+  };
+
+  int maxThreads = libIntegrate::gnuplot::detail::threadCount(0);
+  for(int threads = 1;; threads = std::min(2 * threads, maxThreads)) {
+    BENCHMARK("parallel parser, columnar storage, " + std::to_string(threads) + " threads")
+    {
+      return libIntegrate::gnuplot::readGnuplotColumnsParallel(file.begin(), file.end(), threads).size();
+    };
+    if(threads == maxThreads) break;
+  }
+
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("Grid reconstruction benchmarks", "[.][benchmarks]")
+{
+  using namespace libIntegrate::gnuplot;
+
+  std::vector<DataPoint> blocked, scattered;
+  for(int i = 0; i < 1000; ++i) {
+    for(int j = 0; j < 1000; ++j) {
+      blocked.push_back({i * 0.1, j * 0.2, i * j * 0.02});
+    }
+  }
+  scattered = blocked;
+  std::swap(scattered.front(), scattered.back());
+
+  std::vector<double>              x, y;
+  std::vector<std::vector<double>> z;
+
+  BENCHMARK("1000x1000 blocked grid")
+  {
+    return extract(blocked, x, y, z);
+  };
+
+  BENCHMARK("1000x1000 scattered grid")
+  {
+    return extract(scattered, x, y, z);
+  };
+}
@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <libIntegrate/_1D/CubicSplineRule.hpp>
+#include <libIntegrate/_1D/GregoryRule.hpp>
+#include <libIntegrate/_1D/RandomAccessLambda.hpp>
+#include <libIntegrate/_1D/RiemannRule.hpp>
+#include <libIntegrate/_1D/SimpsonRule.hpp>
+#include <libIntegrate/_1D/TrapezoidRule.hpp>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+using namespace Catch;
+
+namespace ParallelTests
+{
+using libIntegrate::execution::par;
+using libIntegrate::execution::seq;
+
+// run f with each number of threads in [1,max], and return the results.
+template<typename F>
+auto withThreads(int max, F f)
+{
+  std::vector<decltype(f())> results;
+#if defined(_OPENMP)
+  int threads = omp_get_max_threads();
+  for(int n = 1; n <= max; n++) {
+    omp_set_num_threads(n);
+    results.push_back(f());
+  }
+  omp_set_num_threads(threads);
+#else
+  results.push_back(f());
+#endif
+  return results;
+}
+
+template<typename Rule>
+void checkReproducible(const std::vector<double> &x, const std::vector<double> &y)
+{
+  Rule integrate;
+
+  // sub-ranges with an odd and even number of intervals, so the Simpson rule
+  // pairs the intervals differently and has to handle the extra interval at the end.
+  for(auto range : std::vector<std::pair<long, long>>{{0, -1}, {0, -2}, {1, -1}, {3, 100000}, {7, 65543}, {10, 20}}) {
+    INFO("range " << range.first << " " << range.second);
+    double I = integrate(x, y, range.first, range.second);
+    CHECK(integrate(seq, x, y, range.first, range.second) == I);
+    for(auto Ip : withThreads(4, [&]() { return integrate(par, x, y, range.first, range.second); }))
+      CHECK(Ip == I);
+
+    // the scalar loops give the same sum up to rounding
+    auto X = _1D::RandomAccessLambda([&x](long i) { return x[i]; }, [&x]() { return x.size(); });
+    auto Y = _1D::RandomAccessLambda([&y](long i) { return y[i]; }, [&y]() { return y.size(); });
+    CHECK(integrate(par, X, Y, range.first, range.second) == Approx(I).epsilon(1e-12));
+  }
+}
+
+TEST_CASE("Parallel integration is bitwise reproducible.")
+{
+  // several blocks, and a last block that is not full
+  std::size_t         N = 5 * libIntegrate::detail::reductionBlockSize + 1235;
+  std::vector<double> x(N), y(N);
+  for(std::size_t i = 0; i < N; i++) {
+    x[i] = 10. * i / (N - 1) + 1e-6 * std::sin(1. * i);
+    y[i] = std::sin(x[i]) + 1e-3 * std::cos(100 * x[i]);
+  }
+
+  SECTION("Riemann") { checkReproducible<_1D::RiemannRule<double>>(x, y); }
+  SECTION("Trapezoid") { checkReproducible<_1D::TrapezoidRule<double>>(x, y); }
+  SECTION("Simpson") { checkReproducible<_1D::SimpsonRule<double>>(x, y); }
+  SECTION("Cubic spline") { checkReproducible<_1D::CubicSplineRule<double>>(x, y); }
+  SECTION("Gregory") { checkReproducible<_1D::GregoryRule<double>>(x, y); }
+  SECTION("Compensated") { checkReproducible<_1D::TrapezoidRule<double, 0, libIntegrate::summation::Neumaier>>(x, y); }
+  SECTION("Pairwise") { checkReproducible<_1D::SimpsonRule<double, 0, libIntegrate::summation::Pairwise>>(x, y); }
+
+  SECTION("Cumulative")
+  {
+    _1D::TrapezoidRule<double> integrate;
+    auto                       I = integrate.cumulative(x, y);
+    for(auto Ip : withThreads(4, [&]() { return integrate.cumulative(par, x, y); }))
+      CHECK(Ip == I);
+    CHECK(I.back() == Approx(integrate(x, y)).epsilon(1e-12));
+  }
+}
+
+TEST_CASE("Parallel integration strong scaling benchmarks", "[.][benchmarks]")
+{
+  std::size_t         N = 100000000;
+  std::vector<double> x(N), y(N);
+  for(std::size_t i = 0; i < N; i++) {
+    x[i] = 10. * i / (N - 1);
+    y[i] = std::sin(x[i]);
+  }
+
+  auto time = [](auto f) {
+    double t = 1e9;
+    for(int r = 0; r < 5; r++) {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      t = std::min(t, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return t;
+  };
+
+  // the same problem with 1, 2, 4, ... threads.
+  auto scaling = [&](const std::string &name, auto integrate) {
+    int max = 1;
+#if defined(_OPENMP)
+    max = omp_get_num_procs();
+#endif
+    double t1 = 0;
+    for(int n = 1;; n = std::min(2 * n, max)) {
+#if defined(_OPENMP)
+      omp_set_num_threads(n);
+#endif
+      double result, t = time([&]() { result = integrate(par, x, y); });
+      if(n == 1) t1 = t;
+      std::cout << name << ", " << n << " threads: " << t * 1e3 << " ms, speedup " << t1 / t << ", result " << result << "\n";
+      if(n == max) break;
+    }
+  };
+
+  scaling("100M points, Riemann rule", _1D::RiemannRule<double>());
+  scaling("100M points, trapezoid rule", _1D::TrapezoidRule<double>());
+  scaling("100M points, Simpson rule", _1D::SimpsonRule<double>());
+}
+
+}  // namespace ParallelTests
@@ -0,0 +1,285 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <libIntegrate/_1D/QuadraturePlan.hpp>
+#include <libIntegrate/_1D/RandomAccessLambda.hpp>
+#include <libIntegrate/_1D/RiemannRule.hpp>
+#include <libIntegrate/_1D/SimpsonRule.hpp>
+#include <libIntegrate/_1D/TrapezoidRule.hpp>
+#include <libIntegrate/_2D/Grid.hpp>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+using namespace Catch;
+
+namespace QuadraturePlanTests
+{
+using libIntegrate::execution::par;
+
+template<typename Rule>
+void checkPlan(std::size_t N)
+{
+  // non-uniform grid
+  std::vector<double> x(N), y(N), z(N);
+  for(std::size_t i = 0; i < N; i++) {
+    x[i] = 0.1 * i + 0.03 * std::sin(3. * i);
+    y[i] = std::sin(x[i]);
+    z[i] = x[i] * x[i];
+  }
+  auto Y = _1D::RandomAccessLambda([&y](long i) { return y[i]; }, [&y]() { return y.size(); });
+
+  Rule integrate;
+  for(auto range : std::vector<std::pair<long, long>>{{0, -1}, {0, -2}, {1, -1}, {2, 9}, {3, 8}}) {
+    INFO("N " << N << ", range " << range.first << " " << range.second);
+    _1D::QuadraturePlan<double> plan(integrate, x, range.first, range.second);
+    CHECK(plan.size() == N);
+
+    // the plan can be reused for any function on the same grid
+    CHECK(plan(y) == Approx(integrate(x, y, range.first, range.second)).epsilon(1e-12));
+    CHECK(plan(z) == Approx(integrate(x, z, range.first, range.second)).epsilon(1e-12));
+    CHECK(plan(Y) == Approx(plan(y)).epsilon(1e-12));
+    CHECK(plan(par, y) == plan(y));
+  }
+}
+
+TEST_CASE("Quadrature plans give the same integrals as the rules.")
+{
+  for(std::size_t N : {10, 11, 1000}) {
+    checkPlan<_1D::RiemannRule<double>>(N);
+    checkPlan<_1D::TrapezoidRule<double>>(N);
+    checkPlan<_1D::SimpsonRule<double>>(N);
+  }
+
+  SECTION("Weights")
+  {
+    std::vector<double> x = {0, 1, 3, 4};
+    CHECK(_1D::RiemannRule<double>().weights(x) == std::vector<double>{1, 2, 1, 0});
+    CHECK(_1D::TrapezoidRule<double>().weights(x) == std::vector<double>{0.5, 1.5, 1.5, 0.5});
+    CHECK(_1D::TrapezoidRule<double>().weights(x, 1, 2) == std::vector<double>{0, 1, 1, 0});
+
+    // only the weights of the range are stored
+    _1D::QuadraturePlan<double> plan(_1D::TrapezoidRule<double>(), x, 1, 2);
+    CHECK(plan.offset() == 1);
+    CHECK(plan.weights().size() == 2);
+
+    // Simpson's rule integrates quadratics exactly
+    auto w = _1D::SimpsonRule<double>().weights(x);
+    double I = 0;
+    for(std::size_t i = 0; i < x.size(); i++) I += w[i] * x[i] * x[i];
+    CHECK(I == Approx(64. / 3));
+  }
+
+  SECTION("Summation policy")
+  {
+    std::vector<double> x(100000), y(x.size());
+    for(std::size_t i = 0; i < x.size(); i++) {
+      x[i] = 1e-3 * i;
+      y[i] = std::cos(x[i]) + 2;
+    }
+    _1D::QuadraturePlan<double, libIntegrate::summation::Neumaier> plan(_1D::TrapezoidRule<double>(), x);
+    CHECK(plan(y) == Approx(_1D::TrapezoidRule<double, 0, libIntegrate::summation::Neumaier>()(x, y)).epsilon(1e-14));
+  }
+
+  SECTION("Float")
+  {
+    std::vector<float> x(100), y(x.size());
+    for(std::size_t i = 0; i < x.size(); i++) {
+      x[i] = 0.01f * i * i;
+      y[i] = std::sin(x[i]);
+    }
+    _1D::QuadraturePlan<float> plan(_1D::SimpsonRule<float>(), x);
+    CHECK(plan(y) == Approx(_1D::SimpsonRule<float>()(x, y)).epsilon(1e-5));
+  }
+}
+
+TEST_CASE("Quadrature plans can be saved and loaded.")
+{
+  std::vector<double> x(1001), y(x.size());
+  for(std::size_t i = 0; i < x.size(); i++) {
+    x[i] = std::sqrt(1. * i);
+    y[i] = std::exp(-x[i]);
+  }
+  _1D::QuadraturePlan<double> plan(_1D::SimpsonRule<double>(), x, 3, -5);
+
+  std::stringstream buffer;
+  plan.write(buffer);
+  auto loaded = _1D::QuadraturePlan<double>::read(buffer);
+  CHECK(loaded.size() == plan.size());
+  CHECK(loaded.offset() == plan.offset());
+  CHECK(loaded.weights() == plan.weights());
+  CHECK(loaded(y) == plan(y));
+
+  SECTION("Errors")
+  {
+    std::string data = buffer.str();
+
+    std::stringstream bad("not a plan");
+    CHECK_THROWS_AS(_1D::QuadraturePlan<double>::read(bad), std::runtime_error);
+
+    std::stringstream truncated(data.substr(0, data.size() - 3));
+    CHECK_THROWS_AS(_1D::QuadraturePlan<double>::read(truncated), std::runtime_error);
+
+    std::stringstream wrongType(data);
+    CHECK_THROWS_AS(_1D::QuadraturePlan<float>::read(wrongType), std::runtime_error);
+
+    CHECK_THROWS_AS(loaded(std::vector<double>(10)), std::runtime_error);
+    CHECK_THROWS_AS(_1D::QuadraturePlan<double>::read("missing.plan"), std::runtime_error);
+
+    // headers that claim more weights than there are (or than fit in memory)
+    auto header = [&data](std::uint64_t count) {
+      std::string h = data.substr(0, 16);
+      for(std::uint64_t n : {count, std::uint64_t(0), count})
+        for(int b = 0; b < 8; ++b) h += static_cast<char>(n >> (8 * b));
+      return h;
+    };
+    for(std::uint64_t count : {std::uint64_t(1) << 40, std::uint64_t(1) << 61, ~std::uint64_t(0)}) {
+      std::stringstream huge(header(count) + data.substr(40));
+      CHECK_THROWS_AS(_1D::QuadraturePlan<double>::read(huge), std::runtime_error);
+    }
+    std::stringstream exact(header(plan.weights().size()) + data.substr(40));
+    CHECK(_1D::QuadraturePlan<double>::read(exact).weights() == plan.weights());
+  }
+}
+
+// a view of every other column of a row-major block, so neither stride is 1.
+struct StridedView {
+  const double  *p;
+  std::size_t    m, n;
+  const double  *data() const { return p; }
+  std::ptrdiff_t rowStride() const { return 2 * n; }
+  std::ptrdiff_t colStride() const { return 2; }
+  std::size_t    rows() const { return m; }
+  std::size_t    cols() const { return n; }
+  double         operator()(std::size_t i, std::size_t j) const { return p[i * rowStride() + j * colStride()]; }
+};
+
+template<typename Rule>
+void checkBatch(std::size_t M, std::size_t N)
+{
+  using _1D::BatchLayout;
+
+  std::vector<double> x(N);
+  for(std::size_t i = 0; i < N; i++) x[i] = 0.1 * i + 0.03 * std::sin(3. * i);
+
+  // function k in row k, and in column k
+  _2D::Grid<double>                f(M, N), g(N, M);
+  std::vector<std::vector<double>> v(M, std::vector<double>(N));
+  std::vector<double>              block(2 * M * N);
+  for(std::size_t k = 0; k < M; k++)
+    for(std::size_t i = 0; i < N; i++) f(k, i) = g(i, k) = v[k][i] = block[2 * (k * N + i)] = std::sin((1 + 0.1 * k) * x[i]) + k;
+
+  Rule integrate;
+  auto rows    = integrate.batch(x, f);
+  auto columns = integrate.batch(x, g, BatchLayout::Columns);
+  auto vectors = integrate.batch(x, v);
+  auto strided = integrate.batch(x, StridedView{block.data(), M, N});
+  REQUIRE(rows.size() == M);
+  REQUIRE(columns.size() == M);
+  for(std::size_t k = 0; k < M; k++) {
+    INFO("M " << M << ", N " << N << ", function " << k);
+    double I = integrate(x, v[k]);
+    CHECK(rows[k] == Approx(I).epsilon(1e-12));
+    CHECK(columns[k] == Approx(I).epsilon(1e-12));
+    CHECK(vectors[k] == Approx(I).epsilon(1e-12));
+    CHECK(strided[k] == Approx(I).epsilon(1e-12));
+  }
+
+  // a sub-range, and the generic path (a vector of rows, read by column)
+  _1D::QuadraturePlan<double> plan(integrate, x, 2, -3);
+  std::vector<std::vector<double>> t(N, std::vector<double>(M));
+  for(std::size_t k = 0; k < M; k++)
+    for(std::size_t i = 0; i < N; i++) t[i][k] = v[k][i];
+  auto sub = plan.batch(t, BatchLayout::Columns);
+  for(std::size_t k = 0; k < M; k++) CHECK(sub[k] == Approx(integrate(x, v[k], 2, -3)).epsilon(1e-12));
+
+  // the blocks of functions are independent, so the parallel result is the same
+#if defined(_OPENMP)
+  int threads = omp_get_max_threads();
+  omp_set_num_threads(3);
+#endif
+  CHECK(integrate.batch(par, x, f) == rows);
+  CHECK(integrate.batch(par, x, g, BatchLayout::Columns) == columns);
+#if defined(_OPENMP)
+  omp_set_num_threads(threads);
+#endif
+}
+
+TEST_CASE("Batches of functions on the same grid.")
+{
+  // several blocks of functions and tiles of points, neither of them full
+  for(auto size : std::vector<std::pair<std::size_t, std::size_t>>{{1, 10}, {5, 11}, {70, 5001}, {300, 30}}) {
+    checkBatch<_1D::RiemannRule<double>>(size.first, size.second);
+    checkBatch<_1D::TrapezoidRule<double>>(size.first, size.second);
+    checkBatch<_1D::SimpsonRule<double>>(size.first, size.second);
+  }
+
+  SECTION("Errors")
+  {
+    std::vector<double>         x(10);
+    _1D::QuadraturePlan<double> plan(_1D::TrapezoidRule<double>(), x);
+    CHECK_THROWS_AS(plan.batch(_2D::Grid<double>(3, 11)), std::runtime_error);
+    CHECK(plan.batch(_2D::Grid<double>(0, 0)).empty());
+  }
+}
+
+TEST_CASE("Quadrature plan benchmarks", "[.][benchmarks]")
+{
+  // many functions on the same non-uniform grid
+  std::size_t                      N = 10000, M = 1000;
+  std::vector<double>              x(N);
+  std::vector<std::vector<double>> y(M, std::vector<double>(N));
+  for(std::size_t i = 0; i < N; i++) {
+    x[i] = 10. * i / (N - 1) + 1e-4 * std::sin(1. * i);
+    for(std::size_t j = 0; j < M; j++) y[j][i] = std::sin((1 + 1e-3 * j) * x[i]);
+  }
+
+  auto time = [](auto f) {
+    double t = 1e9;
+    for(int r = 0; r < 5; r++) {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      t = std::min(t, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return t;
+  };
+
+  auto compare = [&](const std::string &name, auto integrate) {
+    volatile double             sink = 0;
+    double                      tr   = time([&]() {
+      for(auto &f : y) sink = integrate(x, f);
+    });
+    _1D::QuadraturePlan<double> plan;
+    double                      tc = time([&]() { plan = _1D::QuadraturePlan<double>(integrate, x); });
+    double                      tp = time([&]() {
+      for(auto &f : y) sink = plan(f);
+    });
+    std::cout << name << ", 1000 x 10k points: rule " << tr * 1e3 << " ms, plan " << tp * 1e3 << " ms (+ " << tc * 1e3
+              << " ms to create), speedup " << tr / tp << "\n";
+  };
+  compare("Trapezoid", _1D::TrapezoidRule<double>());
+  compare("Simpson", _1D::SimpsonRule<double>());
+
+  // the same functions in one block, by row and by column
+  _2D::Grid<double> f(M, N), g(N, M);
+  for(std::size_t j = 0; j < M; j++)
+    for(std::size_t i = 0; i < N; i++) f(j, i) = g(i, j) = y[j][i];
+  _1D::TrapezoidRule<double> integrate;
+  volatile double            sink = 0;
+  double                     tr   = time([&]() {
+    for(auto &v : y) sink = integrate(x, v);
+  });
+  double tb = time([&]() { sink = integrate.batch(x, f)[0]; });
+  double tc = time([&]() { sink = integrate.batch(x, g, _1D::BatchLayout::Columns)[0]; });
+  double tp = time([&]() { sink = integrate.batch(par, x, f)[0]; });
+  std::cout << "Trapezoid, 1000 x 10k points: rule " << tr * 1e3 << " ms, batch of rows " << tb * 1e3 << " ms, batch of columns " << tc * 1e3
+            << " ms, parallel batch of rows " << tp * 1e3 << " ms\n";
+}
+
+}  // namespace QuadraturePlanTests
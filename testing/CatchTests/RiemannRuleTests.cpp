@@ -137,6 +137,62 @@ TEST_CASE("Testing 1D Riemann rule with static interval number.")
   REQUIRE(int1(f, 2, 5) == Approx(int2(f, 2, 5, 10)));
 }
 
+TEST_CASE("Riemann rule accumulator matches discretized integration.")
+{
+  _1D::RiemannRule<double>              integrate;
+  _1D::RiemannRule<double>::Accumulator acc;
+
+  std::vector<double> x, y;
+  for(int i = 0; i < 20; i++) {
+    x.push_back(i * i * 0.01);
+    y.push_back(std::sin(x.back()));
+    acc.add(x.back(), y.back());
+    CHECK(acc.size() == x.size());
+    if(x.size() > 2) {
+      CHECK(acc.value() == Approx(integrate(x, y)));
+    }
+  }
+}
+
+TEST_CASE("Riemann rule cumulative integral matches discretized integration.")
+{
+  _1D::RiemannRule<double> integrate;
+
+  std::vector<double> x, y;
+  for(int i = 0; i < 21; i++) {
+    x.push_back(i * i * 0.01);
+    y.push_back(std::sin(x.back()));
+  }
+
+  auto I = integrate.cumulative(x, y);
+  REQUIRE(I.size() == x.size());
+  CHECK(I[0] == 0);
+  for(long n = 1; n < (long)x.size(); n++) {
+    CHECK(I[n] == Approx(integrate(x, y, 0, n)));
+  }
+
+  SECTION("Parallel")
+  {
+    // large enough to use the parallel scan
+    std::size_t N = 100001;
+    x.resize(N);
+    y.resize(N);
+    for(std::size_t i = 0; i < N; i++) {
+      x[i] = 10. * i / (N - 1);
+      y[i] = std::sin(x[i]);
+    }
+
+    auto Is = integrate.cumulative(libIntegrate::execution::seq, x, y);
+    auto Ip = integrate.cumulative(libIntegrate::execution::par, x, y);
+    REQUIRE(Ip.size() == N);
+    CHECK(Is.back() == Approx(integrate(x, y)));
+    CHECK(Ip.back() == Approx(1 - std::cos(10.)).epsilon(1e-4));
+    for(std::size_t i = 0; i < N; i += 997) {
+      CHECK(Ip[i] == Approx(Is[i]).margin(1e-12));
+    }
+  }
+}
+
 TEST_CASE("Riemann Benchmarks", "[.][bencharmks]")
 {
   _2D::RiemannRule<double> integrate;
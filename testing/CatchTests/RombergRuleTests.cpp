@@ -0,0 +1,85 @@
+#include <cmath>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <libIntegrate/Integrand.hpp>
+#include <libIntegrate/_1D/RombergRule.hpp>
+#include <libIntegrate/_1D/SimpsonRule.hpp>
+#include <libIntegrate/_1D/TrapezoidRule.hpp>
+using namespace Catch;
+
+namespace RombergRuleTests
+{
+TEST_CASE("Trapezoid rule refinement reuses the previous evaluations.")
+{
+  _1D::TrapezoidRule<double> integrate;
+  auto                       f = [](double x) { return std::exp(x); };
+
+  std::size_t calls = 0;
+  auto        g     = libIntegrate::EvaluationCounter(f, calls);
+  double      I     = integrate(f, 0., 2., 5);
+  for(std::size_t N = 5; N < 100; N *= 2) {
+    calls = 0;
+    I     = integrate.refine(g, 0., 2., N, I);
+    CHECK(calls == N);
+    CHECK(I == Approx(integrate(f, 0., 2., 2 * N)).epsilon(1e-14));
+  }
+}
+
+TEST_CASE("Romberg integration")
+{
+  _1D::RombergRule<double> integrate;
+  double                   error;
+  std::size_t              evaluations;
+
+  SECTION("Smooth functions converge to the tolerance")
+  {
+    std::size_t calls = 0;
+    auto        f     = libIntegrate::EvaluationCounter([](double x) { return std::exp(x); }, calls);
+    double      exact = std::exp(2.) - 1;
+    for(double tol : {1e-6, 1e-10, 1e-13}) {
+      calls    = 0;
+      double I = integrate(f, 0., 2., 20, tol, &error, &evaluations);
+      INFO("tol " << tol << ", evaluations " << evaluations);
+      CHECK(std::abs(I - exact) <= tol * exact);
+      CHECK(error <= tol * exact);
+      CHECK(evaluations == calls);
+      // far fewer evaluations than Simpson's rule needs for the same accuracy
+      CHECK(evaluations <= 65);
+    }
+    CHECK(std::abs(_1D::SimpsonRule<double>()(f, 0., 2., 32) - exact) > 1e-10 * exact);
+  }
+
+  SECTION("Polynomials are exact after a few levels")
+  {
+    double I = integrate([](double x) { return 5 * std::pow(x, 4) - 3 * x * x + 1; }, -1., 3., 20, 1e-14, &error, &evaluations);
+    CHECK(I == Approx(243 + 1 - 27 - 1 + 4));
+    CHECK(evaluations == 9);
+  }
+
+  SECTION("Vanishing integrals")
+  {
+    double I = integrate([](double x) { return std::sin(2 * M_PI * x); }, 0., 1., 20, 1e-10, &error, &evaluations);
+    CHECK(I == Approx(0).margin(1e-12));
+    CHECK(evaluations < 1000);
+  }
+
+  SECTION("Maximum level")
+  {
+    // the kink is not smooth, so the tolerance is not met.
+    double I = integrate([](double x) { return std::sqrt(std::abs(x)); }, -1., 1., 6, 1e-14, &error, &evaluations);
+    CHECK(evaluations == 65);
+    CHECK(I == Approx(4. / 3).epsilon(1e-2));
+    CHECK(error > 1e-14);
+    CHECK(std::abs(I - 4. / 3) < 10 * error);
+  }
+
+  SECTION("Defaults and summation policies")
+  {
+    CHECK(integrate([](double x) { return 1 / (1 + x * x); }, 0., 1.) == Approx(M_PI / 4));
+    CHECK(_1D::RombergRule<double, libIntegrate::summation::Neumaier>()([](double x) { return std::cos(x); }, 0., 1.) == Approx(std::sin(1.)));
+    CHECK(_1D::RombergRule<float>()([](float x) { return x * x; }, 0.f, 1.f) == Approx(1. / 3));
+  }
+}
+
+}  // namespace RombergRuleTests
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <libIntegrate/Simd.hpp>
+#include <libIntegrate/_1D/RandomAccessLambda.hpp>
+#include <libIntegrate/_1D/RiemannRule.hpp>
+#include <libIntegrate/_1D/SimpsonRule.hpp>
+#include <libIntegrate/_1D/TrapezoidRule.hpp>
+using namespace Catch;
+
+namespace SimdTests
+{
+using libIntegrate::detail::SimdLevel;
+
+// all of the levels supported by this CPU
+std::vector<SimdLevel> supportedLevels()
+{
+  std::vector<SimdLevel> levels;
+  for(auto level : {SimdLevel::portable, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512})
+    if(level <= libIntegrate::detail::simdLevel()) levels.push_back(level);
+  return levels;
+}
+
+// a view of a container that is not detected as contiguous, so the rules use the scalar loops.
+template<typename C>
+auto scalar(const C &c)
+{
+  return _1D::RandomAccessLambda([&c](long i) { return c[i]; }, [&c]() { return c.size(); });
+}
+
+// the sums are added in a different order, float sums with cancellation only agree to a few digits.
+template<typename T>
+Approx approx(double value)
+{
+  return Approx(value).epsilon(std::is_same_v<T, float> ? 1e-3 : 1e-10).margin(std::is_same_v<T, float> ? 1e-5 : 1e-12);
+}
+
+template<typename T, typename S>
+void checkKernels()
+{
+  using namespace libIntegrate::detail;
+
+  for(auto level : supportedLevels()) {
+    INFO("level " << simdLevelName(level));
+    for(std::size_t n = 0; n < 150; n++) {
+      std::vector<T> x(n + 1), y(n + 1);
+      for(std::size_t i = 0; i <= n; i++) {
+        x[i] = i * 0.1 + 0.01 * std::sin(T(i));
+        y[i] = std::cos(x[i]);
+      }
+
+      T even = 0, odd = 0, riemann = 0, trapezoid = 0;
+      for(std::size_t i = 0; i < n; i++) {
+        (i % 2 ? odd : even) += y[i];
+        riemann += y[i] * (x[i + 1] - x[i]);
+        trapezoid += (y[i] + y[i + 1]) * (x[i + 1] - x[i]);
+      }
+
+      CHECK(weightedSum<S>(level, y.data(), n).value() == approx<T>(even + odd));
+      CHECK(weightedSum<S>(level, y.data(), n, T(1), T(0)).value() == approx<T>(even));
+      CHECK(weightedSum<S>(level, y.data(), n, T(2), T(4)).value() == approx<T>(2 * even + 4 * odd));
+      CHECK(intervalSum<S, RiemannInterval>(level, x.data(), y.data(), n).value() == approx<T>(riemann));
+      CHECK(intervalSum<S, TrapezoidInterval>(level, x.data(), y.data(), n).value() == approx<T>(trapezoid));
+
+      // unaligned
+      if(n > 1) {
+        CHECK(weightedSum<S>(level, y.data() + 1, n - 1, T(1), T(0)).value() == approx<T>(odd));
+        CHECK(intervalSum<S, RiemannInterval>(level, x.data() + 1, y.data() + 1, n - 1).value() == approx<T>(riemann - y[0] * (x[1] - x[0])));
+      }
+    }
+  }
+}
+
+TEST_CASE("Vectorized kernels match scalar sums.")
+{
+  using namespace libIntegrate::summation;
+  checkKernels<double, Naive>();
+  checkKernels<float, Naive>();
+  checkKernels<double, Neumaier>();
+  checkKernels<float, Neumaier>();
+  checkKernels<double, Pairwise>();
+  checkKernels<float, Pairwise>();
+  checkKernels<double, DoubleDouble>();
+  checkKernels<float, DoubleDouble>();
+}
+
+TEST_CASE("Contiguous containers are detected.")
+{
+  using libIntegrate::detail::isContiguousOf_v;
+  CHECK(isContiguousOf_v<double, std::vector<double>>);
+  CHECK(isContiguousOf_v<float, std::array<float, 3>>);
+  CHECK(!isContiguousOf_v<double, std::vector<float>>);
+  CHECK(!isContiguousOf_v<int, std::vector<int>>);
+  CHECK(!isContiguousOf_v<double, decltype(scalar(std::vector<double>()))>);
+}
+
+template<typename T>
+void checkRules()
+{
+  _1D::RiemannRule<T>   riemann;
+  _1D::TrapezoidRule<T> trapezoid;
+  _1D::SimpsonRule<T>   simpson;
+
+  for(std::size_t N = 3; N < 100; N++) {
+    std::vector<T> x(N), y(N);
+    for(std::size_t i = 0; i < N; i++) {
+      x[i] = i * i * 0.001;
+      y[i] = std::sin(x[i]);
+    }
+    auto X = scalar(x);
+    auto Y = scalar(y);
+
+    CHECK(riemann(y, T(0.1)) == approx<T>(riemann(Y, T(0.1))));
+    CHECK(trapezoid(y, T(0.1)) == approx<T>(trapezoid(Y, T(0.1))));
+    CHECK(simpson(y, T(0.1)) == approx<T>(simpson(Y, T(0.1))));
+
+    CHECK(riemann(x, y) == approx<T>(riemann(X, Y)));
+    CHECK(trapezoid(x, y) == approx<T>(trapezoid(X, Y)));
+    CHECK(riemann(x, y, 1, -2) == approx<T>(riemann(X, Y, 1, -2)));
+    CHECK(trapezoid(x, y, 1, -2) == approx<T>(trapezoid(X, Y, 1, -2)));
+    CHECK(trapezoid(x, y, 2, 2) == 0);
+  }
+}
+
+TEST_CASE("Rules give the same result for contiguous containers.")
+{
+  checkRules<double>();
+  checkRules<float>();
+}
+
+TEST_CASE("Vectorized kernel benchmarks", "[.][benchmarks]")
+{
+  using namespace libIntegrate::detail;
+
+  // larger than the last level cache, so the kernels are limited by memory bandwidth.
+  std::size_t         N = 1 << 23;
+  std::vector<double> x(N), y(N), buffer(N);
+  for(std::size_t i = 0; i < N; i++) {
+    x[i] = 10. * i / (N - 1);
+    y[i] = std::sin(x[i]);
+  }
+
+  _1D::TrapezoidRule<double> integrate;
+  auto                       X = scalar(x);
+  auto                       Y = scalar(y);
+
+  BENCHMARK("8M points, uniform trapezoid rule, scalar")
+  {
+    return integrate(Y, 0.1);
+  };
+  BENCHMARK("8M points, uniform trapezoid rule, vectorized")
+  {
+    return integrate(y, 0.1);
+  };
+  BENCHMARK("8M points, trapezoid rule, scalar")
+  {
+    return integrate(X, Y);
+  };
+  BENCHMARK("8M points, trapezoid rule, vectorized")
+  {
+    return integrate(x, y);
+  };
+
+  // report the bandwidth of each kernel, compared to copying the same data.
+  auto best = [](auto f) {
+    double t = 1e9;
+    for(int r = 0; r < 10; r++) {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      t = std::min(t, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return t;
+  };
+  auto report = [N](const std::string &name, std::size_t arrays, double t) {
+    std::cout << name << ": " << arrays * N * sizeof(double) / t / 1e9 << " GB/s\n";
+  };
+
+  volatile double sink = 0;
+  report("memcpy (read + write)", 2, best([&]() { std::memcpy(buffer.data(), y.data(), N * sizeof(double)); }));
+  report("uniform scalar", 1, best([&]() { sink = integrate(Y, 0.1); }));
+  report("non-uniform scalar", 2, best([&]() { sink = integrate(X, Y); }));
+  for(auto level : supportedLevels()) {
+    report(std::string("uniform ") + simdLevelName(level), 1, best([&]() { sink = weightedSum<libIntegrate::summation::Naive>(level, y.data(), N).value(); }));
+    report(std::string("non-uniform ") + simdLevelName(level), 2, best([&]() { sink = intervalSum<libIntegrate::summation::Naive, TrapezoidInterval>(level, x.data(), y.data(), N - 1).value(); }));
+  }
+}
+
+}  // namespace SimdTests
@@ -1,3 +1,5 @@
+#include <array>
+#include <cmath>
 #include <iostream>
 #include <numeric>
 
@@ -50,6 +52,28 @@ TEST_CASE("Testing Simpson rule on quadratic functions.")
                     1 * 1 - 3 * 1));
 }
 
+TEST_CASE("Simpson rule evaluates each point once.")
+{
+  std::size_t calls = 0;
+  auto        f     = libIntegrate::EvaluationCounter([](double x) { return x * x * x; }, calls);
+
+  CHECK(_1D::SimpsonRule<double>()(f, 0., 1., 10) == Approx(0.25));
+  CHECK(calls == 21);
+
+  // unrolled, and with a loop.
+  calls = 0;
+  CHECK(_1D::SimpsonRule<double, 10>()(f, 0., 1.) == Approx(0.25));
+  CHECK(calls == 21);
+  calls = 0;
+  _1D::SimpsonRule<double, 1000>()(f, 0., 1.);
+  CHECK(calls == 2001);
+
+  calls = 0;
+  auto g = libIntegrate::EvaluationCounter([](double x) { return std::array<double, 2>{x, x * x * x}; }, calls);
+  CHECK(_1D::SimpsonRule<double>()(g, 0., 1., 10)[1] == Approx(0.25));
+  CHECK(calls == 21);
+}
+
 TEST_CASE("Simpson rule on discretized functions.")
 {
   _1D::SimpsonRule<double> integrate;
@@ -161,6 +185,64 @@ TEST_CASE("Simpson rule on discretized functions.")
   }
 }
 
+TEST_CASE("Simpson rule accumulator matches discretized integration.")
+{
+  _1D::SimpsonRule<double>              integrate;
+  _1D::SimpsonRule<double>::Accumulator acc;
+
+  std::vector<double> x, y;
+  for(int i = 0; i < 20; i++) {
+    x.push_back(i * i * 0.01);
+    y.push_back(std::sin(x.back()));
+    acc.add(x.back(), y.back());
+    CHECK(acc.size() == x.size());
+    if(x.size() > 2) {
+      CHECK(acc.value() == integrate(x, y));
+    }
+  }
+}
+
+TEST_CASE("Simpson rule cumulative integral matches discretized integration.")
+{
+  _1D::SimpsonRule<double> integrate;
+
+  std::vector<double> x, y;
+  for(int i = 0; i < 21; i++) {
+    x.push_back(i * i * 0.01);
+    y.push_back(std::sin(x.back()));
+  }
+
+  auto I = integrate.cumulative(x, y);
+  REQUIRE(I.size() == x.size());
+  CHECK(I[0] == 0);
+  // there are not enough points for a quadratic in the first interval
+  CHECK(I[1] == Approx((x[1] - x[0]) * (y[1] + y[0]) / 2));
+  for(long n = 2; n < (long)x.size(); n++) {
+    CHECK(I[n] == Approx(integrate(x, y, 0, n)));
+  }
+
+  SECTION("Parallel")
+  {
+    // large enough to use the parallel scan
+    std::size_t N = 100001;
+    x.resize(N);
+    y.resize(N);
+    for(std::size_t i = 0; i < N; i++) {
+      x[i] = 10. * i / (N - 1);
+      y[i] = std::sin(x[i]);
+    }
+
+    auto Is = integrate.cumulative(libIntegrate::execution::seq, x, y);
+    auto Ip = integrate.cumulative(libIntegrate::execution::par, x, y);
+    REQUIRE(Ip.size() == N);
+    CHECK(Is.back() == Approx(integrate(x, y)));
+    CHECK(Ip.back() == Approx(1 - std::cos(10.)).epsilon(1e-4));
+    for(std::size_t i = 0; i < N; i += 997) {
+      CHECK(Ip[i] == Approx(Is[i]).margin(1e-12));
+    }
+  }
+}
+
 TEST_CASE("Simpson rule benchmarks.", "[.][benchmarks]")
 {
   _1D::SimpsonRule<double> integrate;
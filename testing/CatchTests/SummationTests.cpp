@@ -0,0 +1,213 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <libIntegrate/Simd.hpp>
+#include <libIntegrate/Summation.hpp>
+#include <libIntegrate/_1D/GaussianQuadratures/GaussLegendre.hpp>
+#include <libIntegrate/_1D/RandomAccessLambda.hpp>
+#include <libIntegrate/_1D/RiemannRule.hpp>
+#include <libIntegrate/_1D/SimpsonRule.hpp>
+#include <libIntegrate/_1D/TrapezoidRule.hpp>
+#include <libIntegrate/_2D/TrapezoidRule.hpp>
+using namespace Catch;
+
+namespace SummationTests
+{
+using namespace libIntegrate::summation;
+
+template<typename S, typename T>
+T sum(const std::vector<T> &terms)
+{
+  Accumulator<S, T> acc;
+  for(auto t : terms) acc.add(t);
+  return acc.value();
+}
+
+TEST_CASE("Summation policies")
+{
+  CHECK(is_summation_policy_v<Naive>);
+  CHECK(is_summation_policy_v<DoubleDouble>);
+  CHECK(!is_summation_policy_v<double>);
+
+  SECTION("Cancellation")
+  {
+    // the small terms are lost when they are added to the large ones.
+    std::vector<double> terms = {1, 1e100, 1, -1e100};
+    CHECK(sum<Naive>(terms) == 0);
+    CHECK(sum<Neumaier>(terms) == 2);
+    CHECK(sum<DoubleDouble>(terms) == 2);
+  }
+
+  SECTION("Many small terms")
+  {
+    // 0.1 is not exact, so compare to the sum of the double values in long double.
+    std::size_t         N = 10000000;
+    std::vector<double> terms(N, 0.1);
+    long double         exact = N * static_cast<long double>(0.1);
+    auto                error = [&](double s) { return std::abs(s - exact) / exact; };
+
+    CHECK(error(sum<Naive>(terms)) > 1e-11);
+    CHECK(error(sum<Neumaier>(terms)) < 1e-15);
+    CHECK(error(sum<Pairwise>(terms)) < 1e-15);
+    CHECK(error(sum<DoubleDouble>(terms)) < 1e-15);
+  }
+
+  SECTION("Merging accumulators")
+  {
+    std::vector<double> terms(1000);
+    for(std::size_t i = 0; i < terms.size(); i++) terms[i] = std::sin(1. * i);
+
+    auto check = [&](auto policy) {
+      using S = decltype(policy);
+      Accumulator<S, double> a, b;
+      for(std::size_t i = 0; i < terms.size(); i++) (i < 357 ? a : b).add(terms[i]);
+      a.add(b);
+      CHECK(a.value() == Approx(sum<S>(terms)).margin(1e-13));
+    };
+    check(Naive());
+    check(Neumaier());
+    check(Pairwise());
+    check(DoubleDouble());
+  }
+}
+
+template<typename S>
+void checkKernelAccuracy()
+{
+  using namespace libIntegrate::detail;
+
+  // the vectorized kernels keep the running sums in each lane, so they are as accurate as the scalar accumulator.
+  std::size_t         N = 1000003;
+  std::vector<double> x(N + 1), y(N + 1, 0.1);
+  for(std::size_t i = 0; i <= N; i++) x[i] = 1e-3 * i;
+  // the terms are rounded to double, and a long double sum of many terms is not accurate enough either.
+  long double                            exact = N * static_cast<long double>(0.1);
+  Accumulator<DoubleDouble, long double> reference;
+  for(std::size_t i = 0; i < N; i++) reference.add(y[i] * (x[i + 1] - x[i]));
+  long double riemann = reference.value();
+
+  for(auto level : {SimdLevel::portable, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+    if(level > simdLevel()) continue;
+    INFO("level " << simdLevelName(level));
+    CHECK(std::abs(weightedSum<S>(level, y.data(), N).value() - exact) / exact < 1e-15);
+    CHECK(std::abs(intervalSum<S, RiemannInterval>(level, x.data(), y.data(), N).value() - riemann) / riemann < 1e-15);
+  }
+}
+
+TEST_CASE("Vectorized kernels are compensated.")
+{
+  SECTION("Neumaier") { checkKernelAccuracy<Neumaier>(); }
+  SECTION("Pairwise") { checkKernelAccuracy<Pairwise>(); }
+  SECTION("DoubleDouble") { checkKernelAccuracy<DoubleDouble>(); }
+}
+
+TEST_CASE("Rules with a summation policy")
+{
+  // many points, compared to the same rule in long double (which uses the scalar loops).
+  using Exact = DoubleDouble;
+  std::size_t              N = 1 << 22;
+  std::vector<double>      x(N), y(N);
+  std::vector<long double> xl(N), yl(N);
+  for(std::size_t i = 0; i < N; i++) {
+    x[i] = xl[i] = 1e-5 * i;
+    y[i] = yl[i] = std::cos(x[i]) + 2;
+  }
+  auto X = _1D::RandomAccessLambda([&x](long i) { return x[i]; }, [&x]() { return x.size(); });
+  auto Y = _1D::RandomAccessLambda([&y](long i) { return y[i]; }, [&y]() { return y.size(); });
+
+  auto check = [&](auto rule, auto exact) {
+    long double I     = exact(xl, yl);
+    long double Iu    = exact(yl, 1e-5L);
+    auto        error = [](double v, long double r) { return std::abs(v - r) / r; };
+    CHECK(error(rule(x, y), I) < 1e-15);
+    CHECK(error(rule(X, Y), I) < 1e-15);
+    CHECK(error(rule(y, 1e-5), Iu) < 1e-15);
+    CHECK(error(rule(Y, 1e-5), Iu) < 1e-15);
+  };
+
+  SECTION("Riemann") { check(_1D::RiemannRule<double, 0, Neumaier>(), _1D::RiemannRule<long double, 0, Exact>()); }
+  SECTION("Trapezoid") { check(_1D::TrapezoidRule<double, 0, DoubleDouble>(), _1D::TrapezoidRule<long double, 0, Exact>()); }
+  SECTION("Simpson") { check(_1D::SimpsonRule<double, 0, Pairwise>(), _1D::SimpsonRule<long double, 0, Exact>()); }
+
+  SECTION("Callables")
+  {
+    auto f = [](double x) { return std::cos(x) + 2; };
+    CHECK(_1D::TrapezoidRule<double, 0, Neumaier>()(f, 0., 1., 1000) == Approx(std::sin(1.) + 2).epsilon(1e-6));
+    CHECK(_1D::SimpsonRule<double, 0, Neumaier>()(f, 0., 1., 1000) == Approx(std::sin(1.) + 2));
+    CHECK(_1D::GQ::GaussLegendreQuadrature<double, 64, Neumaier>()(f, 0., 1.) == Approx(std::sin(1.) + 2));
+  }
+
+  SECTION("2D")
+  {
+    _2D::TrapezoidRule<double, Neumaier> integrate;
+    CHECK(integrate([](double x, double y) { return x * y; }, 0., 1., 100, 0., 2., 100) == Approx(1.));
+  }
+}
+
+template<typename Rule>
+double stream(std::size_t K)
+{
+  // the odd points cycle through 0.75, 0.75e100, 0.75, -0.75e100 and the even
+  // points are 0, so the terms of each rule are exact, but naive summation
+  // loses the small terms next to the large ones.
+  const double               odd[4] = {0.75, 0.75e100, 0.75, -0.75e100};
+  typename Rule::Accumulator acc;
+  for(std::size_t i = 0; i <= 8 * K; i++) acc.add(i, i % 2 ? odd[(i / 2) % 4] : 0.);
+  return acc.value();
+}
+
+TEST_CASE("Streaming accumulators with a summation policy")
+{
+  std::size_t K = 1000;
+  CHECK(stream<_1D::RiemannRule<double, 0, Neumaier>>(K) == Approx(1.5 * K));
+  CHECK(stream<_1D::TrapezoidRule<double, 0, Neumaier>>(K) == Approx(1.5 * K));
+  CHECK(stream<_1D::SimpsonRule<double, 0, Neumaier>>(K) == Approx(2. * K));
+  CHECK(stream<_1D::TrapezoidRule<double, 0, DoubleDouble>>(K) == Approx(1.5 * K));
+
+  CHECK(std::abs(stream<_1D::RiemannRule<double>>(K) - 1.5 * K) > K);
+  CHECK(std::abs(stream<_1D::TrapezoidRule<double>>(K) - 1.5 * K) > K);
+  CHECK(std::abs(stream<_1D::SimpsonRule<double>>(K) - 2. * K) > K);
+}
+
+TEST_CASE("Summation policy benchmarks", "[.][benchmarks]")
+{
+  // the cost of each policy in the vectorized and scalar loops, relative to naive summation.
+  std::size_t         N = 1 << 23;
+  std::vector<double> x(N), y(N);
+  for(std::size_t i = 0; i < N; i++) {
+    x[i] = 10. * i / (N - 1);
+    y[i] = std::sin(x[i]);
+  }
+  auto X = _1D::RandomAccessLambda([&x](long i) { return x[i]; }, [&x]() { return x.size(); });
+  auto Y = _1D::RandomAccessLambda([&y](long i) { return y[i]; }, [&y]() { return y.size(); });
+
+  auto best = [](auto f) {
+    double t = 1e9;
+    for(int r = 0; r < 10; r++) {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      t = std::min(t, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return t;
+  };
+
+  volatile double sink = 0;
+  double          t0 = 0, s0 = 0;
+  auto            report = [&](const char *name, auto integrate) {
+    double t = best([&]() { sink = integrate(x, y); });
+    double s = best([&]() { sink = integrate(X, Y); });
+    if(t0 == 0) t0 = t, s0 = s;
+    std::cout << "8M points, trapezoid rule, " << name << ": vectorized " << t * 1e3 << " ms (" << t / t0 << "x), scalar " << s * 1e3
+              << " ms (" << s / s0 << "x)\n";
+  };
+  report("naive", _1D::TrapezoidRule<double>());
+  report("Neumaier", _1D::TrapezoidRule<double, 0, Neumaier>());
+  report("pairwise", _1D::TrapezoidRule<double, 0, Pairwise>());
+  report("double-double", _1D::TrapezoidRule<double, 0, DoubleDouble>());
+}
+
+}  // namespace SummationTests
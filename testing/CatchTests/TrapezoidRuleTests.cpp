@@ -1,3 +1,4 @@
+#include <array>
 #include <cmath>
 #include <numeric>
 
@@ -124,6 +125,28 @@ TEST_CASE("Testing 1D Trapezoid rule with static interval number.")
   REQUIRE(I == Approx(5 * 5 + 3 * 5 - 2 * 2 - 3 * 2));
 }
 
+TEST_CASE("Trapezoid rule evaluates each point once.")
+{
+  std::size_t calls = 0;
+  auto        f     = libIntegrate::EvaluationCounter([](double x) { return x * x; }, calls);
+
+  CHECK(_1D::TrapezoidRule<double>()(f, 0., 1., 10) == Approx(0.335));
+  CHECK(calls == 11);
+
+  // unrolled, and with a loop.
+  calls = 0;
+  CHECK(_1D::TrapezoidRule<double, 10>()(f, 0., 1.) == Approx(0.335));
+  CHECK(calls == 11);
+  calls = 0;
+  _1D::TrapezoidRule<double, 1000>()(f, 0., 1.);
+  CHECK(calls == 1001);
+
+  calls = 0;
+  auto g = libIntegrate::EvaluationCounter([](double x) { return std::array<double, 2>{x, x * x}; }, calls);
+  CHECK(_1D::TrapezoidRule<double>()(g, 0., 1., 10)[1] == Approx(0.335));
+  CHECK(calls == 11);
+}
+
 }  // namespace TrapeziodRuleTests
 
 TEST_CASE("2D Trapezoid Rule")
@@ -165,6 +188,62 @@ TEST_CASE("2D Trapezoid Rule")
   }
 }
 
+TEST_CASE("Trapezoid rule accumulator matches discretized integration.")
+{
+  _1D::TrapezoidRule<double>              integrate;
+  _1D::TrapezoidRule<double>::Accumulator acc;
+
+  std::vector<double> x, y;
+  for(int i = 0; i < 20; i++) {
+    x.push_back(i * i * 0.01);
+    y.push_back(std::sin(x.back()));
+    acc.add(x.back(), y.back());
+    CHECK(acc.size() == x.size());
+    if(x.size() > 2) {
+      CHECK(acc.value() == Approx(integrate(x, y)));
+    }
+  }
+}
+
+TEST_CASE("Trapezoid rule cumulative integral matches discretized integration.")
+{
+  _1D::TrapezoidRule<double> integrate;
+
+  std::vector<double> x, y;
+  for(int i = 0; i < 21; i++) {
+    x.push_back(i * i * 0.01);
+    y.push_back(std::sin(x.back()));
+  }
+
+  auto I = integrate.cumulative(x, y);
+  REQUIRE(I.size() == x.size());
+  CHECK(I[0] == 0);
+  for(long n = 1; n < (long)x.size(); n++) {
+    CHECK(I[n] == Approx(integrate(x, y, 0, n)));
+  }
+
+  SECTION("Parallel")
+  {
+    // large enough to use the parallel scan
+    std::size_t N = 100001;
+    x.resize(N);
+    y.resize(N);
+    for(std::size_t i = 0; i < N; i++) {
+      x[i] = 10. * i / (N - 1);
+      y[i] = std::sin(x[i]);
+    }
+
+    auto Is = integrate.cumulative(libIntegrate::execution::seq, x, y);
+    auto Ip = integrate.cumulative(libIntegrate::execution::par, x, y);
+    REQUIRE(Ip.size() == N);
+    CHECK(Is.back() == Approx(integrate(x, y)));
+    CHECK(Ip.back() == Approx(1 - std::cos(10.)).epsilon(1e-4));
+    for(std::size_t i = 0; i < N; i += 997) {
+      CHECK(Ip[i] == Approx(Is[i]).margin(1e-12));
+    }
+  }
+}
+
 TEST_CASE("Trapezoid Rule Benchmarks", "[.][benchmarks]")
 {
   int                 N = 1000;
@@ -188,3 +267,25 @@ TEST_CASE("Trapezoid Rule Benchmarks", "[.][benchmarks]")
     return sum;
   };
 }
+
+TEST_CASE("Cumulative integral benchmarks", "[.][benchmarks]")
+{
+  std::size_t         N = 1 << 22;
+  std::vector<double> x(N), y(N);
+  for(std::size_t i = 0; i < N; i++) {
+    x[i] = 10. * i / (N - 1);
+    y[i] = std::sin(x[i]);
+  }
+
+  _1D::TrapezoidRule<double> integrate;
+
+  BENCHMARK("4M points, sequential")
+  {
+    return integrate.cumulative(libIntegrate::execution::seq, x, y).back();
+  };
+
+  BENCHMARK("4M points, parallel")
+  {
+    return integrate.cumulative(libIntegrate::execution::par, x, y).back();
+  };
+}
@@ -0,0 +1,100 @@
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <libIntegrate/_1D/RiemannRule.hpp>
+#include <libIntegrate/_1D/SimpsonRule.hpp>
+#include <libIntegrate/_1D/TrapezoidRule.hpp>
+using namespace Catch;
+
+namespace UnrolledRuleTests
+{
+using namespace libIntegrate::summation;
+
+// integrals with a fixed number of intervals are constant expressions.
+constexpr auto square = [](double x) { return x * x; };
+static_assert(_1D::TrapezoidRule<double, 4>()(square, 0., 2.) == 2.75);
+static_assert(_1D::RiemannRule<double, 4>()(square, 0., 2.) == 1.75);
+static_assert(_1D::SimpsonRule<double, 8>()(square, 0., 3.) > 9 - 1e-12 && _1D::SimpsonRule<double, 8>()(square, 0., 3.) < 9 + 1e-12);
+static_assert(_1D::TrapezoidRule<double, 4, Neumaier>()(square, 0., 2.) == 2.75);
+static_assert(_1D::TrapezoidRule<double, 4, Pairwise>()(square, 0., 2.) == 2.75);
+static_assert(_1D::TrapezoidRule<double, 4, DoubleDouble>()(square, 0., 2.) == 2.75);
+
+// a lookup table of atan(x) = \int_0^x dt/(1+t^2), computed by the compiler.
+constexpr std::array<double, 17> atanTable()
+{
+  std::array<double, 17> table{};
+  for(std::size_t k = 0; k < table.size(); k++)
+    table[k] = _1D::SimpsonRule<double, 32>()([](double t) { return 1 / (1 + t * t); }, 0., k / 16.);
+  return table;
+}
+constexpr auto table = atanTable();
+
+template<typename S>
+void checkUnrolled()
+{
+  auto f = [](double x) { return std::exp(-x) * std::sin(3 * x); };
+  CHECK(_1D::RiemannRule<double, 8, S>()(f, 0.5, 2.) == Approx(_1D::RiemannRule<double, 0, S>()(f, 0.5, 2., 8)).epsilon(1e-14));
+  CHECK(_1D::TrapezoidRule<double, 8, S>()(f, 0.5, 2.) == Approx(_1D::TrapezoidRule<double, 0, S>()(f, 0.5, 2., 8)).epsilon(1e-14));
+  CHECK(_1D::SimpsonRule<double, 8, S>()(f, 0.5, 2.) == Approx(_1D::SimpsonRule<double, 0, S>()(f, 0.5, 2., 8)).epsilon(1e-14));
+  CHECK(_1D::SimpsonRule<double, 64, S>()(f, 0.5, 2.) == Approx(_1D::SimpsonRule<double, 0, S>()(f, 0.5, 2., 64)).epsilon(1e-14));
+}
+
+TEST_CASE("Unrolled rules with a fixed number of intervals")
+{
+  SECTION("Same as the loops")
+  {
+    checkUnrolled<Naive>();
+    checkUnrolled<Neumaier>();
+    checkUnrolled<Pairwise>();
+    checkUnrolled<DoubleDouble>();
+  }
+
+  SECTION("Lookup table")
+  {
+    for(std::size_t k = 0; k < table.size(); k++) CHECK(table[k] == Approx(std::atan(k / 16.)).epsilon(1e-9));
+  }
+
+  SECTION("More intervals than are unrolled")
+  {
+    auto f = [](double x) { return x * x; };
+    CHECK(_1D::TrapezoidRule<double, 1000>()(f, 0., 1.) == Approx(1. / 3).epsilon(1e-6));
+    CHECK(_1D::SimpsonRule<double, 1000>()(f, 0., 1.) == Approx(1. / 3));
+    CHECK(_1D::RiemannRule<double, 1000>()(f, 0., 1.) == Approx(1. / 3).epsilon(1e-2));
+  }
+}
+
+TEST_CASE("Unrolled rule benchmarks", "[.][benchmarks]")
+{
+  // an inner integral in a hot loop.
+  std::size_t M    = 1000000;
+  auto        time = [](auto g) {
+    auto start = std::chrono::steady_clock::now();
+    g();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+  volatile double sink = 0;
+  auto            run  = [&](auto integrate) {
+    double sum = 0;
+    for(std::size_t i = 0; i < M; i++) {
+      double y = 1e-6 * i;
+      sum += integrate([y](double x) { return x * x * y + x; }, 0., 1.);
+    }
+    sink = sum;
+  };
+  _1D::SimpsonRule<double> simpson;
+  _1D::TrapezoidRule<double> trapezoid;
+  double tr = time([&]() { run([&](auto f, double a, double b) { return simpson(f, a, b, 8); }); });
+  double tu = time([&]() { run(_1D::SimpsonRule<double, 8>()); });
+  std::cout << "1M inner Simpson integrals with 8 intervals: loop " << tr * 1e3 << " ms, unrolled " << tu * 1e3 << " ms, speedup " << tr / tu
+            << "\n";
+  tr = time([&]() { run([&](auto f, double a, double b) { return trapezoid(f, a, b, 8); }); });
+  tu = time([&]() { run(_1D::TrapezoidRule<double, 8>()); });
+  std::cout << "1M inner trapezoid integrals with 8 intervals: loop " << tr * 1e3 << " ms, unrolled " << tu * 1e3 << " ms, speedup "
+            << tr / tu << "\n";
+}
+
+}  // namespace UnrolledRuleTests
@@ -0,0 +1,140 @@
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <libIntegrate/_1D/CubicSplineRule.hpp>
+#include <libIntegrate/_1D/GaussianQuadratures/GaussLegendre.hpp>
+#include <libIntegrate/_1D/GregoryRule.hpp>
+#include <libIntegrate/_1D/RiemannRule.hpp>
+#include <libIntegrate/_1D/SimpsonRule.hpp>
+#include <libIntegrate/_1D/TrapezoidRule.hpp>
+#include <libIntegrate/_2D/GaussianQuadratures/GaussLegendre.hpp>
+#include <libIntegrate/_2D/TrapezoidRule.hpp>
+using namespace Catch;
+
+namespace VectorIntegrandTests
+{
+// a vector with a size set at run time, indexed with operator() like Eigen::VectorXd.
+struct DynamicVector {
+  std::vector<double> v;
+  std::size_t         size() const { return v.size(); }
+  double             &operator()(std::size_t i) { return v[i]; }
+  double              operator()(std::size_t i) const { return v[i]; }
+};
+
+template<typename Rule>
+void checkRule(Rule integrate, double tol)
+{
+  // one evaluation gives all of the components.
+  int  calls = 0;
+  auto f     = [&calls](double x) {
+    calls++;
+    return std::array<double, 3>{std::sin(x), x * x, 1.};
+  };
+  auto I = integrate(f, 0., 2.);
+  int  n = calls;
+
+  auto component = [&](std::size_t c) { return integrate([&f, c](double x) { return f(x)[c]; }, 0., 2.); };
+  for(std::size_t c = 0; c < 3; c++) CHECK(I[c] == Approx(component(c)).epsilon(1e-14));
+  CHECK(I[0] == Approx(1 - std::cos(2.)).epsilon(tol));
+  CHECK(I[1] == Approx(8. / 3).epsilon(tol));
+  CHECK(I[2] == Approx(2.));
+  // integrating all of the components costs no more evaluations than integrating one.
+  CHECK(n <= (calls - n) / 3);
+
+  DynamicVector J = integrate([](double x) { return DynamicVector{{std::sin(x), x * x, 1., 0.}}; }, 0., 2.);
+  REQUIRE(J.size() == 4);
+  for(std::size_t c = 0; c < 3; c++) CHECK(J(c) == Approx(I[c]).epsilon(1e-14));
+  CHECK(J(3) == 0);
+
+  std::vector<double> K = integrate([](double x) { return std::vector<double>{std::sin(x), x * x}; }, 0., 2.);
+  REQUIRE(K.size() == 2);
+  CHECK(K[1] == Approx(I[1]).epsilon(1e-14));
+}
+
+template<typename T, std::size_t NN, typename S>
+struct Fixed {
+  // the callable rules with the number of intervals set at run time.
+  template<template<typename, std::size_t, typename> class Rule>
+  struct Runtime {
+    template<typename F>
+    auto operator()(F f, T a, T b) const
+    {
+      return Rule<T, 0, S>()(f, a, b, NN);
+    }
+  };
+};
+
+TEST_CASE("Vector-valued integrands")
+{
+  using S = libIntegrate::summation::Naive;
+  SECTION("Riemann") { checkRule(Fixed<double, 2000, S>::Runtime<_1D::RiemannRule>(), 1e-3); }
+  SECTION("Trapezoid") { checkRule(Fixed<double, 200, S>::Runtime<_1D::TrapezoidRule>(), 1e-4); }
+  SECTION("Simpson") { checkRule(Fixed<double, 100, S>::Runtime<_1D::SimpsonRule>(), 1e-8); }
+  SECTION("Cubic spline") { checkRule(Fixed<double, 100, S>::Runtime<_1D::CubicSplineRule>(), 1e-5); }
+  SECTION("Gregory") { checkRule(Fixed<double, 100, S>::Runtime<_1D::GregoryRule>(), 1e-8); }
+  SECTION("Gauss-Legendre") { checkRule(_1D::GQ::GaussLegendreQuadrature<double, 16>(), 1e-12); }
+  SECTION("Fixed number of intervals")
+  {
+    checkRule(_1D::TrapezoidRule<double, 200>(), 1e-4);
+    checkRule(_1D::SimpsonRule<double, 100>(), 1e-8);
+  }
+  SECTION("Summation policy")
+  {
+    checkRule(Fixed<double, 100, libIntegrate::summation::Neumaier>::Runtime<_1D::SimpsonRule>(), 1e-8);
+    checkRule(_1D::GQ::GaussLegendreQuadrature<double, 16, libIntegrate::summation::Pairwise>(), 1e-12);
+  }
+
+  SECTION("2D")
+  {
+    auto f = [](double x, double y) { return std::array<double, 2>{x * y, 1.}; };
+
+    auto I = _2D::GQ::GaussLegendreQuadrature<double, 8>()(f, 0., 1., 0., 2.);
+    CHECK(I[0] == Approx(1.));
+    CHECK(I[1] == Approx(2.));
+
+    int  calls = 0;
+    auto J     = _2D::TrapezoidRule<double>()(
+        [&](double x, double y) {
+          calls++;
+          return f(x, y);
+        },
+        0., 1., 10, 0., 2., 20);
+    CHECK(J[0] == Approx(1.));
+    CHECK(J[1] == Approx(2.));
+    CHECK(calls == 11 * 21);
+  }
+}
+
+TEST_CASE("Vector-valued integrand benchmarks", "[.][benchmarks]")
+{
+  // an integrand with 32 components that share one expensive evaluation.
+  constexpr std::size_t M = 32;
+  auto                  f = [](double x) {
+    std::array<double, M> v;
+    double                e = 0;
+    for(int k = 0; k < 200; k++) e += std::exp(-k * x) / (1 + k);
+    for(std::size_t c = 0; c < M; c++) v[c] = e * std::pow(x, 1. * c);
+    return v;
+  };
+  auto time = [](auto g) {
+    auto start = std::chrono::steady_clock::now();
+    g();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  _1D::SimpsonRule<double> integrate;
+  volatile double          sink = 0;
+  double                   tc   = time([&]() {
+    for(std::size_t c = 0; c < M; c++) sink = integrate([&f, c](double x) { return f(x)[c]; }, 0., 1., 1000);
+  });
+  double tv = time([&]() { sink = integrate(f, 0., 1., 1000)[M - 1]; });
+  std::cout << "Simpson, 32 components, 1000 intervals: one component at a time " << tc * 1e3 << " ms, all components " << tv * 1e3
+            << " ms, speedup " << tc / tv << "\n";
+}
+
+}  // namespace VectorIntegrandTests